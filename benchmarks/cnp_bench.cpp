@@ -0,0 +1,123 @@
+#include <CNPFuncs.hpp>
+#include <chrono>
+#include <random>
+
+
+// MICROBENCHMARKS FOR THE SORT BASED NUMPY-LIKE FUNCTIONS. EVERY FUNCTION IS
+// TIMED ON INTEGER AND REAL INPUTS OF INCREASING SIZE, THE TIME PER ENTRY
+// SHOULD STAY ROUGHLY FLAT. SMALL INPUTS ARE CHECKED AGAINST NAIVE REFERENCES
+
+template<typename F>
+Real TimeIt(F func, Integer repeats=3)
+{
+    //! BEST WALL TIME OF A FEW RUNS IN SECONDS
+    Real best = std::numeric_limits<Real>::max();
+    for (Integer r=0; r<repeats; ++r)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        func();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best,std::chrono::duration<Real>(t1-t0).count());
+    }
+    return best;
+}
+
+void Check(bool condition, const char *name, const char *dtype)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << name << " <" << dtype << ">" << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+template<typename T>
+void Validate(const Eigen::Matrix<T,DYNAMIC,1> &arr, const char *dtype)
+{
+    //! COMPARE AGAINST BRUTE FORCE REFERENCES
+    const Integer n = arr.rows();
+    std::vector<T> ref_uniques;
+    std::vector<Integer> ref_first, ref_counts;
+    for (Integer i=0; i<n; ++i)
+    {
+        auto it = std::find(ref_uniques.begin(),ref_uniques.end(),arr(i));
+        if (it==ref_uniques.end())
+        {
+            ref_uniques.push_back(arr(i));
+            ref_first.push_back(i);
+            ref_counts.push_back(1);
+        }
+        else
+            ++ref_counts[it-ref_uniques.begin()];
+    }
+    std::vector<Integer> order = cnp::argsort(ref_uniques);
+
+    std::vector<T> uniques;
+    std::vector<Integer> first;
+    std::tie(uniques,first) = cnp::unique(arr);
+    Check(uniques.size()==order.size(),"unique",dtype);
+    for (UInteger i=0; i<order.size(); ++i)
+    {
+        Check(uniques[i]==ref_uniques[order[i]],"unique",dtype);
+        Check(first[i]==ref_first[order[i]],"unique",dtype);
+    }
+
+    std::vector<T> varr(arr.data(),arr.data()+n);
+    std::tie(uniques,first) = cnp::unique(varr,true);
+    for (UInteger i=0; i<order.size(); ++i)
+        Check(first[i]==ref_first[order[i]],"unique(std::vector)",dtype);
+
+    auto freqs = cnp::itemfreq(arr);
+    auto vfreqs = cnp::itemfreq(varr);
+    for (UInteger i=0; i<order.size(); ++i)
+    {
+        Check(freqs(i,0)==ref_uniques[order[i]] && Integer(freqs(i,1))==ref_counts[order[i]],"itemfreq",dtype);
+        Check(vfreqs(i,0)==ref_uniques[order[i]] && Integer(vfreqs(i,1))==ref_counts[order[i]],"itemfreq(std::vector)",dtype);
+    }
+
+    Eigen::MatrixUI rows;
+    std::tie(rows,std::ignore) = cnp::where_eq(arr,ref_uniques[0]);
+    Check(Integer(rows.rows())==ref_counts[0],"where_eq",dtype);
+}
+
+template<typename T>
+void Run(const char *dtype, Integer n, std::mt19937_64 &engine)
+{
+    // ROUGHLY 16 REPETITIONS OF EVERY VALUE, AS FOR SURFACE FLAGS OF FACES
+    std::uniform_int_distribution<Integer> dist(-n/32,n/32);
+    Eigen::Matrix<T,DYNAMIC,1> arr(n);
+    for (Integer i=0; i<n; ++i)
+        arr(i) = T(dist(engine));
+    std::vector<T> varr(arr.data(),arr.data()+n);
+
+    if (n <= 10000)
+        Validate(arr,dtype);
+
+    const Real t_unique = TimeIt([&]{ cnp::unique(arr); });
+    const Real t_vunique = TimeIt([&]{ cnp::unique(varr,true); });
+    const Real t_itemfreq = TimeIt([&]{ cnp::itemfreq(arr); });
+    const Real t_where_eq = TimeIt([&]{ cnp::where_eq(arr,arr(0)); });
+
+    const Real to_ns = 1.0e9/n;
+    std::printf("%-8s %10lld %12.2f %12.2f %12.2f %12.2f\n",dtype,n,
+                t_unique*to_ns,t_vunique*to_ns,t_itemfreq*to_ns,t_where_eq*to_ns);
+}
+
+int main(int argc, char *argv[])
+{
+    // LARGEST INPUT SIZE CAN BE PASSED AS THE FIRST ARGUMENT
+    const Integer max_size = argc > 1 ? std::atoll(argv[1]) : 10000000;
+    std::mt19937_64 engine(1234);
+
+    std::printf("%-8s %10s %12s %12s %12s %12s\n","dtype","n",
+                "unique","unique(vec)","itemfreq","where_eq");
+    std::printf("%-8s %10s %12s %12s %12s %12s\n","","","ns/entry","ns/entry","ns/entry","ns/entry");
+    for (Integer n=10000; n<=max_size; n*=10)
+    {
+        Run<Integer>("Integer",n,engine);
+        Run<UInteger>("UInteger",n,engine);
+        Run<Real>("Real",n,engine);
+    }
+
+    return 0;
+}
@@ -0,0 +1,438 @@
+#include <PostMeshSurface.hpp>
+#include <BRepPrimAPI_MakeSphere.hxx>
+#include <BRepPrimAPI_MakeTorus.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <BRepFilletAPI_MakeFillet.hxx>
+#include <BRepBuilderAPI_MakeFace.hxx>
+#include <GeomAPI_PointsToBSplineSurface.hxx>
+#include <TColgp_Array2OfPnt.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopExp.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <chrono>
+#include <fstream>
+
+
+// SCALING BENCHMARK OF THE 3D SURFACE PROJECTION PIPELINE. THE 2D CURVE
+// PIPELINE IS NOT COVERED. THE CAD MODELS ARE BUILT IN MEMORY AND THE HIGH
+// ORDER BOUNDARY MESHES ARE SAMPLED FROM THEM, SO NO INPUT FILES ARE NEEDED.
+// EVERY RUN IS REPORTED AS A JSON RECORD WITH THE PHASE TIMES AND COUNTERS
+// OF PostMeshStats
+//
+// USAGE: pipeline_bench [--shapes sphere,torus,cylinder,nurbs] [--elements tet,hex]
+//                       [--min-faces 1e3] [--max-faces 1e4] [--degree 2]
+//                       [--patches 16] [--output FILE] [--trace FILE]
+
+
+typedef std::chrono::steady_clock Clock;
+
+ALWAYS_INLINE Real Seconds(const Clock::time_point &start)
+{
+    return std::chrono::duration<Real>(Clock::now()-start).count();
+}
+
+std::vector<std::string> Split(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream,item,','))
+        if (!item.empty()) items.push_back(item);
+    return items;
+}
+
+
+//! SYNTHETIC CAD MODELS
+TopoDS_Shape MakeFilletedCylinder()
+{
+    //! A CLOSED CYLINDER WITH BOTH RIMS ROUNDED, FIVE FACES
+    TopoDS_Shape cylinder = BRepPrimAPI_MakeCylinder(30.,80.).Shape();
+    TopTools_IndexedMapOfShape edges;
+    TopExp::MapShapes(cylinder,TopAbs_EDGE,edges);
+
+    BRepFilletAPI_MakeFillet fillet(cylinder);
+    for (Integer i=1; i<=edges.Extent(); ++i)
+    {
+        TopoDS_Edge edge = TopoDS::Edge(edges(i));
+        if (BRepAdaptor_Curve(edge).GetType()==GeomAbs_Circle)
+            fillet.Add(5.,edge);
+    }
+    fillet.Build();
+    if (!fillet.IsDone())
+    {
+        warn("Filleting the cylinder failed, using the sharp cylinder instead");
+        return cylinder;
+    }
+    return fillet.Shape();
+}
+
+ALWAYS_INLINE Real Height(Real x, Real y)
+{
+    return 8.*std::sin(x/9.)*std::cos(y/13.) + 0.002*x*y;
+}
+
+TopoDS_Shape MakeNURBSPatches(Integer patches)
+{
+    //! A WAVY HEIGHT FIELD OVER [0,100]x[0,100] SPLIT INTO patches x patches
+    //! FREEFORM B-SPLINE FACES, EACH FITTED THROUGH A GRID OF SAMPLES
+    constexpr Integer samples = 6;
+    const Real width = 100./patches;
+
+    BRep_Builder builder;
+    TopoDS_Compound compound;
+    builder.MakeCompound(compound);
+    for (Integer ipatch=0; ipatch<patches; ++ipatch)
+    {
+        for (Integer jpatch=0; jpatch<patches; ++jpatch)
+        {
+            TColgp_Array2OfPnt points(1,samples,1,samples);
+            for (Integer i=0; i<samples; ++i)
+            {
+                for (Integer j=0; j<samples; ++j)
+                {
+                    const Real x = (ipatch + Real(i)/(samples-1))*width;
+                    const Real y = (jpatch + Real(j)/(samples-1))*width;
+                    points.SetValue(i+1,j+1,gp_Pnt(x,y,Height(x,y)));
+                }
+            }
+            Handle_Geom_Surface surface = GeomAPI_PointsToBSplineSurface(points).Surface();
+            builder.Add(compound,BRepBuilderAPI_MakeFace(surface,1.0e-06).Face());
+        }
+    }
+    return compound;
+}
+
+TopoDS_Shape MakeShape(const std::string &name, Integer patches)
+{
+    if (name=="sphere")
+        return BRepPrimAPI_MakeSphere(50.).Shape();
+    else if (name=="torus")
+        return BRepPrimAPI_MakeTorus(50.,15.).Shape();
+    else if (name=="cylinder")
+        return MakeFilletedCylinder();
+    else if (name=="nurbs")
+        return MakeNURBSPatches(patches);
+    warn("Unknown benchmark shape", name);
+    std::exit(EXIT_FAILURE);
+}
+
+
+//! SYNTHETIC HIGH ORDER BOUNDARY MESHES
+struct SyntheticMesh
+{
+    Eigen::MatrixR points;
+    Eigen::MatrixIndexUI faces;
+};
+
+std::vector<std::array<Integer,2> > LocalNodes(const std::string &element_type, Integer degree, bool upper)
+{
+    //! LATTICE OFFSETS OF THE NODES OF A FACE INSIDE ITS CELL, VERTICES FIRST.
+    //! A CELL IS SPLIT INTO A LOWER AND AN UPPER TRIANGLE ALONG ITS DIAGONAL
+    const Integer p = degree;
+    std::vector<std::array<Integer,2> > nodes;
+    if (element_type=="tet")
+    {
+        if (!upper) nodes = {{{0,0}},{{p,0}},{{0,p}}};
+        else nodes = {{{p,p}},{{0,p}},{{p,0}}};
+    }
+    else
+        nodes = {{{0,0}},{{p,0}},{{p,p}},{{0,p}}};
+    const Integer no_vertices = nodes.size();
+
+    for (Integer a=0; a<=p; ++a)
+    {
+        for (Integer b=0; b<=p; ++b)
+        {
+            if (element_type=="tet" && (upper ? a+b<p : a+b>p)) continue;
+            std::array<Integer,2> node = {{a,b}};
+            if (std::find(nodes.begin(),nodes.begin()+no_vertices,node)==nodes.begin()+no_vertices)
+                nodes.push_back(node);
+        }
+    }
+    return nodes;
+}
+
+SyntheticMesh MakeBoundaryMesh(const TopoDS_Shape &shape, const std::string &element_type,
+                               Integer degree, Integer target_faces)
+{
+    //! COVER THE PARAMETRIC DOMAIN OF EVERY CAD FACE WITH AN n x n GRID OF
+    //! CELLS, ONE QUAD OR TWO TRIANGLES PER CELL. CELL VERTICES LIE ON THE
+    //! SURFACE WHILE THE HIGH ORDER NODES ARE INTERPOLATED ON THE STRAIGHT
+    //! SIDED FACES, SO THEY ARE OFF THE SURFACE AND NEED TO BE PROJECTED.
+    //! TRIMMED FACES ARE SAMPLED OVER THEIR PARAMETRIC BOUNDING BOX AND THE
+    //! MESHES OF NEIGHBOURING CAD FACES ARE NOT STITCHED
+    std::vector<TopoDS_Face> cad_faces;
+    for (TopExp_Explorer explorer(shape,TopAbs_FACE); explorer.More(); explorer.Next())
+        cad_faces.push_back(TopoDS::Face(explorer.Current()));
+    if (cad_faces.empty())
+    {
+        warn("The benchmark shape has no faces");
+        std::exit(EXIT_FAILURE);
+    }
+
+    const bool tet = element_type=="tet";
+    const Integer faces_per_cell = tet ? 2 : 1;
+    const Integer cells = std::max(Integer(1),target_faces/(faces_per_cell*Integer(cad_faces.size())));
+    const Integer n = std::max(Integer(1),Integer(std::ceil(std::sqrt(Real(cells)))));
+    const Integer p = degree;
+    const Integer lattice = p*n+1;
+
+    const auto lower_nodes = LocalNodes(element_type,p,false);
+    const auto upper_nodes = LocalNodes(element_type,p,true);
+    const Integer no_face_nodes = lower_nodes.size();
+
+    SyntheticMesh mesh;
+    mesh.points.resize(cad_faces.size()*lattice*lattice,3);
+    mesh.faces.resize(cad_faces.size()*n*n*faces_per_cell,no_face_nodes);
+
+    for (UInteger iface=0; iface<cad_faces.size(); ++iface)
+    {
+        // CELL VERTICES ON THE SURFACE, EVALUATED SERIALLY AS OCC SURFACE
+        // EVALUATORS CACHE STATE
+        BRepAdaptor_Surface surface(cad_faces[iface]);
+        const Real u0 = surface.FirstUParameter(), u1 = surface.LastUParameter();
+        const Real v0 = surface.FirstVParameter(), v1 = surface.LastVParameter();
+        Eigen::MatrixR corners((n+1)*(n+1),3);
+        for (Integer i=0; i<=n; ++i)
+        {
+            for (Integer j=0; j<=n; ++j)
+            {
+                gp_Pnt point = surface.Value(u0+(u1-u0)*i/n,v0+(v1-v0)*j/n);
+                corners(i*(n+1)+j,0) = point.X();
+                corners(i*(n+1)+j,1) = point.Y();
+                corners(i*(n+1)+j,2) = point.Z();
+            }
+        }
+
+        const Integer point_offset = iface*lattice*lattice;
+        parallel_for(0,lattice,[&](Integer lo, Integer hi)
+        {
+            for (Integer a=lo; a<hi; ++a)
+            {
+                const Integer ci = std::min(a/p,n-1);
+                const Real s = Real(a-ci*p)/p;
+                for (Integer b=0; b<lattice; ++b)
+                {
+                    const Integer cj = std::min(b/p,n-1);
+                    const Real t = Real(b-cj*p)/p;
+                    auto P00 = corners.row(ci*(n+1)+cj);
+                    auto P10 = corners.row((ci+1)*(n+1)+cj);
+                    auto P01 = corners.row(ci*(n+1)+cj+1);
+                    auto P11 = corners.row((ci+1)*(n+1)+cj+1);
+                    auto point = mesh.points.row(point_offset+a*lattice+b);
+                    if (!tet)
+                        point = (1-s)*(1-t)*P00 + s*(1-t)*P10 + (1-s)*t*P01 + s*t*P11;
+                    else if (s+t<=1)
+                        point = P00 + s*(P10-P00) + t*(P01-P00);
+                    else
+                        point = P11 + (1-s)*(P01-P11) + (1-t)*(P10-P11);
+                }
+            }
+        },64);
+
+        const Integer face_offset = iface*n*n*faces_per_cell;
+        parallel_for(0,n*n,[&](Integer lo, Integer hi)
+        {
+            for (Integer cell=lo; cell<hi; ++cell)
+            {
+                const Integer ci = cell/n, cj = cell%n;
+                for (Integer k=0; k<faces_per_cell; ++k)
+                {
+                    const auto &nodes = k==0 ? lower_nodes : upper_nodes;
+                    const Integer row = face_offset+cell*faces_per_cell+k;
+                    for (Integer inode=0; inode<no_face_nodes; ++inode)
+                    {
+                        mesh.faces(row,inode) = point_offset + (ci*p+nodes[inode][0])*lattice + cj*p+nodes[inode][1];
+                    }
+                }
+            }
+        },1024);
+    }
+
+    return mesh;
+}
+
+
+//! PIPELINE
+struct RunRecord
+{
+    std::string shape;
+    std::string element_type;
+    Integer cad_faces;
+    Integer mesh_faces;
+    Integer mesh_points;
+    Integer dirichlet_nodes;
+    Real cad_time;
+    Real mesh_time;
+    Real pipeline_time;
+    PostMeshStats stats;
+};
+
+RunRecord Run(const std::string &shape_name, const TopoDS_Shape &shape, Real cad_time,
+              std::string element_type, Integer degree, Integer target_faces)
+{
+    RunRecord record;
+    record.shape = shape_name;
+    record.element_type = element_type;
+    record.cad_time = cad_time;
+    record.cad_faces = 0;
+    for (TopExp_Explorer explorer(shape,TopAbs_FACE); explorer.More(); explorer.Next())
+        ++record.cad_faces;
+
+    auto start = Clock::now();
+    SyntheticMesh mesh = MakeBoundaryMesh(shape,element_type,degree,target_faces);
+    record.mesh_time = Seconds(start);
+    record.mesh_faces = mesh.faces.rows();
+    record.mesh_points = mesh.points.rows();
+
+    // THE BOUNDARY MESH IS ALREADY IN CAD UNITS AND EVERY FACE IS PROJECTED
+    start = Clock::now();
+    PostMeshSurface postmesh(element_type,3);
+    postmesh.SetMeshPoints(mesh.points.data(),mesh.points.rows(),mesh.points.cols(),true);
+    postmesh.SetMeshFaces(mesh.faces.data(),mesh.faces.rows(),mesh.faces.cols(),true);
+    postmesh.SetScale(1.0);
+    postmesh.SetCondition(1.0e10);
+    postmesh.SetProjectionPrecision(1.0e-07);
+    postmesh.ComputeProjectionCriteria();
+    postmesh.SetShape(shape);
+    postmesh.GetGeomVertices();
+    postmesh.GetGeomEdges();
+    postmesh.GetGeomFaces();
+    postmesh.GetGeomPointsOnCorrespondingFaces();
+    postmesh.IdentifySurfacesContainingFaces();
+    postmesh.IdentifySurfacesIntersections();
+    postmesh.ProjectMeshOnSurface();
+    postmesh.RepairDualProjectedParameters();
+    postmesh.MeshPointInversionSurface(1,1);
+    record.dirichlet_nodes = postmesh.GetDirichletDataSize();
+    record.pipeline_time = Seconds(start);
+    record.stats = postmesh.GetStats();
+
+    return record;
+}
+
+void WriteJSON(std::ostream &out, const std::vector<RunRecord> &records, Integer degree)
+{
+    out << "{\n";
+    out << "  \"benchmark\": \"pipeline\",\n";
+    out << "  \"threads\": " << GetNumberOfThreads() << ",\n";
+    out << "  \"degree\": " << degree << ",\n";
+    out << "  \"runs\": [";
+    for (UInteger irun=0; irun<records.size(); ++irun)
+    {
+        const RunRecord &record = records[irun];
+        const PostMeshStats &stats = record.stats;
+        out << (irun ? ",\n" : "\n") << "    {\n";
+        out << "      \"shape\": \"" << record.shape << "\",\n";
+        out << "      \"element_type\": \"" << record.element_type << "\",\n";
+        out << "      \"cad_faces\": " << record.cad_faces << ",\n";
+        out << "      \"mesh_faces\": " << record.mesh_faces << ",\n";
+        out << "      \"mesh_points\": " << record.mesh_points << ",\n";
+        out << "      \"dirichlet_nodes\": " << record.dirichlet_nodes << ",\n";
+        out << "      \"cad_seconds\": " << record.cad_time << ",\n";
+        out << "      \"mesh_seconds\": " << record.mesh_time << ",\n";
+        out << "      \"pipeline_seconds\": " << record.pipeline_time << ",\n";
+        out << "      \"phases\": {";
+        for (UInteger iphase=0; iphase<stats.phases.size(); ++iphase)
+        {
+            out << (iphase ? ",\n" : "\n") << "        \"" << stats.phases[iphase].first
+                << "\": " << stats.phases[iphase].second;
+        }
+        out << "\n      },\n";
+        out << "      \"projections\": {\n";
+        out << "        \"point_on_curve\": " << stats.projections_on_curve << ",\n";
+        out << "        \"point_on_surface\": " << stats.projections_on_surface << ",\n";
+        out << "        \"extrema_on_surface\": " << stats.extrema_on_surface << ",\n";
+        out << "        \"newton_on_curve\": " << stats.newton_on_curve << "\n";
+        out << "      },\n";
+        out << "      \"projection_failures\": " << stats.projection_failures << ",\n";
+        out << "      \"vertex_snaps\": " << stats.vertex_snaps << ",\n";
+        out << "      \"unresolved_faces\": " << stats.unresolved_faces << ",\n";
+        out << "      \"peak_rss\": " << stats.peak_rss << "\n";
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> shapes = {"sphere","torus","cylinder","nurbs"};
+    std::vector<std::string> element_types = {"tet","hex"};
+    Integer min_faces = 1000, max_faces = 10000, degree = 2, patches = 16;
+    std::string output, trace;
+
+    for (Integer i=1; i<argc; i+=2)
+    {
+        const std::string option = argv[i];
+        if (i+1==argc)
+        {
+            warn("Missing value for option", option);
+            return EXIT_FAILURE;
+        }
+        const std::string value = argv[i+1];
+        try
+        {
+            if (option=="--shapes") shapes = Split(value);
+            else if (option=="--elements") element_types = Split(value);
+            else if (option=="--min-faces") min_faces = Integer(std::stod(value));
+            else if (option=="--max-faces") max_faces = Integer(std::stod(value));
+            else if (option=="--degree") degree = std::stoll(value);
+            else if (option=="--patches") patches = std::stoll(value);
+            else if (option=="--output") output = value;
+            else if (option=="--trace") trace = value;
+            else
+            {
+                warn("Unknown option", option);
+                return EXIT_FAILURE;
+            }
+        }
+        catch (std::logic_error &)
+        {
+            warn("Invalid value for option", option, value);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (min_faces < 1 || max_faces < min_faces || degree < 1 || patches < 1)
+    {
+        warn("Expected 1 <= --min-faces <= --max-faces, --degree >= 1 and --patches >= 1");
+        return EXIT_FAILURE;
+    }
+
+    if (!trace.empty())
+        StartTrace();
+
+    std::vector<RunRecord> records;
+    for (const auto &shape_name: shapes)
+    {
+        auto start = Clock::now();
+        TopoDS_Shape shape = MakeShape(shape_name,patches);
+        const Real cad_time = Seconds(start);
+
+        for (const auto &element_type: element_types)
+        {
+            for (Integer target_faces=min_faces; ; target_faces*=10)
+            {
+                records.push_back(Run(shape_name,shape,cad_time,element_type,degree,target_faces));
+                const RunRecord &record = records.back();
+                std::fprintf(stderr,"%-10s %-4s %10lld faces %12.3f s\n",shape_name.c_str(),
+                             element_type.c_str(),record.mesh_faces,record.pipeline_time);
+                // STOP BEFORE THE NEXT SIZE EXCEEDS max_faces (OR OVERFLOWS)
+                if (target_faces > max_faces/10) break;
+            }
+        }
+    }
+
+    if (output.empty())
+        WriteJSON(std::cout,records,degree);
+    else
+    {
+        std::ofstream file(output);
+        WriteJSON(file,records,degree);
+    }
+    if (!trace.empty())
+        WriteTrace(trace.c_str());
+
+    return 0;
+}
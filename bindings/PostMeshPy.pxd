@@ -1,12 +1,18 @@
 from cython import double
 from libcpp.vector cimport vector
 from libcpp.string cimport string
+from libcpp.pair cimport pair
+from libc.stdint cimport uint64_t
 
 
 ctypedef long long Integer
 ctypedef unsigned long long UInteger
 ctypedef double Real
 
+cdef extern from "STL_INC.hpp":
+    # CONNECTIVITY INDEX, 32-BIT WHEN BUILT WITH POSTMESH_INDEX32
+    ctypedef unsigned long long IndexUI
+
 cdef extern from "PyInterface.hpp":
 
     struct DirichletData:
@@ -15,27 +21,97 @@ cdef extern from "PyInterface.hpp":
         Integer nodes_dir_size
 
 
+cdef extern from "IOFuncs.hpp" namespace "postmesh_io":
+
+    uint64_t checksum(const void *data, size_t nbytes)
+
+
+cdef extern from "PostMeshTrace.hpp":
+
+    void StartTrace_ "StartTrace"()
+    void StopTrace_ "StopTrace"()
+    bint WriteTrace_ "WriteTrace"(const char *filename)
+
+
+cdef extern from "PostMeshDiagnostics.hpp":
+
+    ctypedef enum Severity:
+        SEVERITY_INFO
+        SEVERITY_WARNING
+        SEVERITY_ERROR
+
+    const char* SeverityName(Severity severity)
+
+    cdef cppclass DiagnosticRecord:
+        Severity severity
+        string kind
+        Integer count
+        vector[string] examples
+
+    ctypedef void (*DiagnosticsCallback)(void *context, const string &phase, const DiagnosticRecord &record)
+
+
+cdef extern from "PostMeshStats.hpp":
+
+    cdef cppclass SurfaceCost:
+        Real identification_time
+        Real projection_time
+        Real inversion_time
+        Integer projections
+        Integer failures
+        Integer extrema_calls
+        Integer extrema_solutions
+        Real worst_residual
+        Real TotalTime()
+        Real MeanExtremaSolutions()
+
+    cdef cppclass PostMeshStats:
+        vector[pair[string,Real]] phases
+        Integer projections_on_curve
+        Integer projections_on_surface
+        Integer extrema_on_surface
+        Integer newton_on_curve
+        Integer projection_failures
+        Integer vertex_snaps
+        Integer unresolved_faces
+        Integer peak_rss
+        vector[SurfaceCost] surfaces
+        SurfaceCost& Surface(Integer isurface)
+        vector[Integer] SurfaceOrder(const string &sort_by) except +
+
+
 cdef extern from "PostMeshBase.hpp":
 
     cdef cppclass PostMeshBase:
         PostMeshBase() except +
         PostMeshBase(string &element_type, const UInteger &dim) except +
         UInteger ndim
+        vector[Integer] parts_surfaces
+        vector[Integer] parts_curves
         void Init(string &element_type, const UInteger &dim) except +
         void SetScale(const Real &scale)
         void SetCondition(const Real &condition)
         void SetProjectionPrecision(const Real &precision)
         void SetProjectionCriteria(UInteger *criteria, Integer &rows, Integer &cols)
         void ComputeProjectionCriteria()
-        void SetMeshElements(UInteger *arr, const Integer &rows, const Integer &cols)
-        void SetMeshPoints(Real *arr, Integer &rows, Integer &cols)
-        void SetMeshEdges(UInteger *arr, const Integer &rows, const Integer &cols)
-        void SetMeshFaces(UInteger *arr, const Integer &rows, const Integer &cols)
+        void SetMeshElements(IndexUI *arr, const Integer &rows, const Integer &cols, bint borrow)
+        void SetMeshPoints(Real *arr, Integer &rows, Integer &cols, bint borrow)
+        void SetMeshEdges(IndexUI *arr, const Integer &rows, const Integer &cols, bint borrow)
+        void SetMeshFaces(IndexUI *arr, const Integer &rows, const Integer &cols, bint borrow)
         void ScaleMesh()
         string GetMeshElementType()
-        void SetNodalSpacing(Real *arr, const Integer &rows, const Integer &cols)
+        void SetNodalSpacing(Real *arr, const Integer &rows, const Integer &cols, bint borrow)
+        void SetCADCacheDirectory(const char* directory)
         void ReadIGES(const char* filename)
+        void ReadBREP(const char* filename) except +
+        void ReadCADFiles(const vector[string] &filenames) except +
+        void ReadBREPString(const string &brep) except +
         void ReadSTEP(const char* filename)
+        void ReadGmsh(const char* filename) except +
+        void ReadMeshBinary(const char* filename, bint verify) except +
+        void WriteMeshBinary(const char* filename) except +
+        void ExtractBoundaryFaces() except +
+        void ExtractBoundaryEdges() except +
         void GetGeomVertices()
         void GetGeomEdges()
         void GetGeomFaces()
@@ -43,7 +119,15 @@ cdef extern from "PostMeshBase.hpp":
         Integer NbPoints()
         Integer NbCurves()
         Integer NbSurfaces()
+        UInteger SurfaceType(UInteger isurface)
         DirichletData GetDirichletData()
+        Integer GetDirichletDataSize()
+        void FillDirichletData(Integer *nodes_dir_out, Real *displacements_BC_out) except +
+        const PostMeshStats& GetStats()
+        void ResetStats()
+        void SetDiagnosticsFile(const char *filename)
+        void SetDiagnosticsCallback(DiagnosticsCallback callback, void *context)
+        void SetDiagnosticsLimits(Integer max_examples, Integer min_severity)
 
 
 cdef extern from "PostMeshCurve.hpp":
@@ -63,6 +147,7 @@ cdef extern from "PostMeshCurve.hpp":
         void MeshPointInversionCurveArcLength()
         void GetBoundaryPointsOrder()
         void ReturnModifiedMeshPoints(Real *points)
+        void WriteVTU(const char* filename) except +
 
 
 cdef extern from "PostMeshSurface.hpp":
@@ -85,6 +170,8 @@ cdef extern from "PostMeshSurface.hpp":
         void ReturnModifiedMeshPoints(Real *points)
         vector[vector[Integer]] GetMeshFacesOnPlanarSurfaces()
         vector[Integer] GetDirichletFaces()
+        void WriteVTU(const char* filename) except +
+        void WriteSurfaceProfile(const char* filename, const string &sort_by) except +
 
 
 cdef extern from "PyInterfaceEmulator.hpp":
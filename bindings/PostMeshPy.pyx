@@ -9,8 +9,138 @@ import numpy as np
 cimport numpy as np
 
 from warnings import warn
+import struct
+from collections import OrderedDict
+
+__all__ = ["PostMeshBasePy","PostMeshCurvePy","PostMeshSurfacePy","WriteMeshBinary","ReadMeshBinary",
+    "StartTrace","StopTrace","WriteTrace","INDEX_DTYPE"]
+
+# DTYPE OF THE CONNECTIVITY ARRAYS, np.uint32 IF BUILT WITH INDEX32=1
+INDEX_DTYPE = np.dtype(np.uint32) if sizeof(IndexUI) == 4 else np.dtype(np.uint64)
+
+
+# LAYOUT OF THE BINARY MESH CONTAINER, SEE IOFuncs.hpp
+_BINARY_MAGIC = b"PMSHBIN\0"
+_BINARY_VERSION = 1
+_BINARY_ENDIANNESS = 0x01020304
+_BINARY_ALIGNMENT = 64
+_BINARY_HEADER = struct.Struct("=8sIIQQ32x")
+_BINARY_RECORD = struct.Struct("=32sIIQQQQQ")
+_BINARY_DTYPES = {np.dtype(np.int32):1, np.dtype(np.uint32):2, np.dtype(np.int64):3,
+    np.dtype(np.uint64):4, np.dtype(np.float64):5}
+
+
+def WriteMeshBinary(str filename, **arrays):
+    """Write numpy arrays to a PostMesh binary mesh container. Arrays are given
+    as keyword arguments, for instance
+
+        WriteMeshBinary("mesh.pmb", elements=elements, points=points, faces=faces)
+
+    The names understood by PostMeshBasePy.ReadMeshBinary are elements, points,
+    edges, faces, nodal_spacing and projection_criteria. Integer connectivity
+    arrays should be of type INDEX_DTYPE and coordinates of type np.float64,
+    connectivity of another integer type is converted when read
+    """
+    cdef np.ndarray arr
+    records, data = [], []
+    offset = _BINARY_HEADER.size + len(arrays)*_BINARY_RECORD.size
+    for name, value in arrays.items():
+        arr = np.ascontiguousarray(value)
+        if arr.ndim == 1:
+            arr = arr.reshape(arr.shape[0],1)
+        if arr.ndim != 2:
+            raise ValueError("Only 1D and 2D arrays can be written to a binary container")
+        if arr.dtype not in _BINARY_DTYPES:
+            raise TypeError("Unsupported data type {} for array {}".format(arr.dtype,name))
+        if len(name) >= 32:
+            raise ValueError("Array name {} is too long".format(name))
+        offset = (offset + _BINARY_ALIGNMENT - 1)//_BINARY_ALIGNMENT*_BINARY_ALIGNMENT
+        records.append(_BINARY_RECORD.pack(str.encode(name), _BINARY_DTYPES[arr.dtype], arr.itemsize,
+            arr.shape[0], arr.shape[1], offset, arr.nbytes, checksum(np.PyArray_DATA(arr), arr.nbytes)))
+        data.append((offset,arr))
+        offset += arr.nbytes
+
+    with open(filename,"wb") as f:
+        f.write(_BINARY_HEADER.pack(_BINARY_MAGIC, _BINARY_VERSION, _BINARY_ENDIANNESS,
+            len(arrays), _BINARY_HEADER.size))
+        for record in records:
+            f.write(record)
+        for offset, arr in data:
+            f.write(b"\0"*(offset - f.tell()))
+            f.write(arr.tobytes())
+
+
+def ReadMeshBinary(str filename, verify=True):
+    """Read a PostMesh binary mesh container. Returns a dictionary of numpy arrays
+    that are copy-on-write memory maps of the file, i.e. nothing is read until the
+    arrays are accessed and modifying them does not modify the file
+    """
+    cdef np.ndarray arr
+    with open(filename,"rb") as f:
+        magic, version, endianness, narrays, table_offset = _BINARY_HEADER.unpack(f.read(_BINARY_HEADER.size))
+        if magic != _BINARY_MAGIC:
+            raise ValueError("{} is not a PostMesh binary container".format(filename))
+        if endianness != _BINARY_ENDIANNESS:
+            raise ValueError("{} was written on a machine with different byte order".format(filename))
+        if version > _BINARY_VERSION:
+            raise ValueError("{} was written by a newer version of PostMesh".format(filename))
+        f.seek(table_offset)
+        records = [_BINARY_RECORD.unpack(f.read(_BINARY_RECORD.size)) for i in range(narrays)]
+
+    dtypes = {code:dtype for dtype, code in _BINARY_DTYPES.items()}
+    arrays = {}
+    for name, dtype, itemsize, rows, cols, offset, nbytes, check in records:
+        name = name.rstrip(b"\0").decode()
+        if nbytes == 0:
+            arrays[name] = np.zeros((rows,cols),dtype=dtypes[dtype])
+            continue
+        arr = np.memmap(filename, dtype=dtypes[dtype], mode="c", offset=offset, shape=(rows,cols))
+        if verify and checksum(np.PyArray_DATA(arr), nbytes) != check:
+            raise ValueError("Checksum mismatch for array {} in {}".format(name,filename))
+        arrays[name] = arr
+    return arrays
+
+
+def _AsIndexArray(array):
+    # CONNECTIVITY OF ANOTHER TYPE THAN INDEX_DTYPE IS CONVERTED, I.E. COPIED
+    arr = np.asarray(array)
+    if arr.dtype != INDEX_DTYPE:
+        if arr.size and (arr.min() < 0 or arr.max() > np.iinfo(INDEX_DTYPE).max):
+            raise OverflowError("Connectivity does not fit into {}".format(INDEX_DTYPE))
+        arr = arr.astype(INDEX_DTYPE)
+    return np.ascontiguousarray(arr)
+
+
+def StartTrace():
+    """Start recording a timeline of every PostMesh phase and every block of its
+    parallel loops. Tracing is process wide and discards any earlier trace"""
+    StartTrace_()
+
+
+def StopTrace():
+    """Stop recording the timeline, keeping the events recorded so far"""
+    StopTrace_()
+
+
+def WriteTrace(str filename):
+    """Stop tracing and write the timeline as a Chrome trace event file, which
+    can be opened in chrome://tracing or ui.perfetto.dev"""
+    if not WriteTrace_(filename.encode()):
+        raise IOError("Could not write trace file {}".format(filename))
+
+
+_SEVERITIES = {"info":SEVERITY_INFO, "warning":SEVERITY_WARNING, "error":SEVERITY_ERROR}
+
+cdef void _diagnostics_callback(void *context, const string &phase, const DiagnosticRecord &record) noexcept with gil:
+    # PYTHON ERRORS CANNOT PROPAGATE THROUGH THE C++ PHASES, REPORT AND CARRY ON
+    cdef size_t i
+    try:
+        examples = [record.examples[i].decode() for i in range(record.examples.size())]
+        (<object>context)(phase.decode(), SeverityName(record.severity).decode().lower(),
+            record.kind.decode(), record.count, examples)
+    except Exception as e:
+        warn("Diagnostics callback raised {}".format(repr(e)))
 
-__all__ = ["PostMeshBasePy","PostMeshCurvePy","PostMeshSurfacePy"]
 
 cdef class PostMeshBasePy:
     """
@@ -26,10 +156,15 @@ cdef class PostMeshBasePy:
 
     # CREATE A POINTER TO CPP BASE CLASS
     cdef PostMeshBase *baseptr
+    # KEEP ARRAYS BORROWED BY THE CPP OBJECT ALIVE
+    cdef dict borrowed_arrays
+    # KEEP THE DIAGNOSTICS CALLBACK ALIVE
+    cdef object diagnostics_callback
 
     def __cinit__(self, str py_element_type, UInteger dimension=2):
 
         self.ndim = dimension
+        self.borrowed_arrays = {}
         # CONVERT TO CPP STRING EXPLICITLY
         cdef string cpp_element_type = str.encode(py_element_type)
         # CREATE A NEW CPP OBJECT BY CALLING ITS CONSTRUCTOR
@@ -74,21 +209,43 @@ cdef class PostMeshBasePy:
         radius specifed through SetCondition"""
         self.baseptr.ComputeProjectionCriteria()
 
-    def SetMeshElements(self,UInteger[:,::1] elements):
-        """Set up elements of the linear mesh"""
-        self.baseptr.SetMeshElements(&elements[0,0],elements.shape[0],elements.shape[1])
-
-    def SetMeshPoints(self,Real[:,::1] points):
-        """Set up nodal coordinates of the linear mesh"""
-        self.baseptr.SetMeshPoints(&points[0,0],points.shape[0],points.shape[1])
-
-    def SetMeshEdges(self,UInteger[:,::1] edges):
-        """Set up boundary edges of the linear mesh"""
-        self.baseptr.SetMeshEdges(&edges[0,0],edges.shape[0],edges.shape[1])
-
-    def SetMeshFaces(self,UInteger[:,::1] faces):
-        """Set up boundary faces of the linear mesh"""
-        self.baseptr.SetMeshFaces(&faces[0,0],faces.shape[0],faces.shape[1])
+    def _Borrow(self, str name, array, bint borrow):
+        # ARRAYS ARE BORROWED RATHER THAN COPIED IF REQUESTED, IN WHICH CASE
+        # A REFERENCE IS HELD FOR AS LONG AS THE CPP OBJECT USES THEM
+        if borrow:
+            self.borrowed_arrays[name] = array
+        else:
+            self.borrowed_arrays.pop(name,None)
+        return borrow
+
+    def SetMeshElements(self, elements, bint borrow=False):
+        """Set up elements of the linear mesh. If borrow is True the array is
+        used in place instead of being copied and must not be modified while
+        PostMesh uses it. Arrays not of type INDEX_DTYPE are converted first"""
+        elements = _AsIndexArray(elements)
+        cdef IndexUI[:,::1] arr = elements
+        self.baseptr.SetMeshElements(&arr[0,0],arr.shape[0],arr.shape[1],
+            self._Borrow("elements",elements,borrow))
+
+    def SetMeshPoints(self,Real[:,::1] points, bint borrow=False):
+        """Set up nodal coordinates of the linear mesh. If borrow is True the
+        array is used in place and only copied once PostMesh modifies the points"""
+        self.baseptr.SetMeshPoints(&points[0,0],points.shape[0],points.shape[1],
+            self._Borrow("points",points,borrow))
+
+    def SetMeshEdges(self, edges, bint borrow=False):
+        """Set up boundary edges of the linear mesh, see SetMeshElements for borrow"""
+        edges = _AsIndexArray(edges)
+        cdef IndexUI[:,::1] arr = edges
+        self.baseptr.SetMeshEdges(&arr[0,0],arr.shape[0],arr.shape[1],
+            self._Borrow("edges",edges,borrow))
+
+    def SetMeshFaces(self, faces, bint borrow=False):
+        """Set up boundary faces of the linear mesh, see SetMeshElements for borrow"""
+        faces = _AsIndexArray(faces)
+        cdef IndexUI[:,::1] arr = faces
+        self.baseptr.SetMeshFaces(&arr[0,0],arr.shape[0],arr.shape[1],
+            self._Borrow("faces",faces,borrow))
 
     def ScaleMesh(self):
         """Scale mesh to match the CAD geometry"""
@@ -99,15 +256,16 @@ cdef class PostMeshBasePy:
         cdef bytes py_element_type = cpp_element_type
         return py_element_type
 
-    def SetNodalSpacing(self, Real[:,::1] spacing):
+    def SetNodalSpacing(self, Real[:,::1] spacing, bint borrow=False):
         """Set nodal spacing of high order points in the mesh.
         spacing has to be given in the isoparametric domain of finite element,
         for instance equally-spaced, Gauss-Lobatto or Fekete point spacing
         """
-        self.baseptr.SetNodalSpacing(&spacing[0,0],spacing.shape[0],spacing.shape[1])
+        self.baseptr.SetNodalSpacing(&spacing[0,0],spacing.shape[0],spacing.shape[1],
+            self._Borrow("spacing",spacing,borrow))
 
-    def SetMesh(self,UInteger[:,::1] elements, Real[:,::1] points,
-        UInteger[:,::1] edges, UInteger[:,::1] faces, Real[:,::1] spacing, scale_mesh=True):
+    def SetMesh(self, elements, Real[:,::1] points,
+        edges, faces, Real[:,::1] spacing, scale_mesh=True, borrow=False):
         """Convenience method for Python interface for setting up the linear mesh
 
             input:
@@ -122,15 +280,56 @@ cdef class PostMeshBasePy:
                                         point spacing
                 scale_mesh:             [bool] True/False, to scale or not to scale the
                                         mesh based on CAD geometry
+                borrow:                 [bool] use the arrays in place instead of copying
+                                        them. They must not be modified while in use by
+                                        PostMesh. Points are copied on first modification
                 """
 
-        self.baseptr.SetMeshElements(&elements[0,0],elements.shape[0],elements.shape[1])
-        self.baseptr.SetMeshPoints(&points[0,0],points.shape[0],points.shape[1])
-        self.baseptr.SetMeshEdges(&edges[0,0],edges.shape[0],edges.shape[1])
-        self.baseptr.SetMeshFaces(&faces[0,0],faces.shape[0],faces.shape[1])
+        self.SetMeshElements(elements,borrow)
+        self.SetMeshPoints(points,borrow)
+        self.SetMeshEdges(edges,borrow)
+        self.SetMeshFaces(faces,borrow)
         if scale_mesh:
             self.baseptr.ScaleMesh()
-        self.baseptr.SetNodalSpacing(&spacing[0,0],spacing.shape[0],spacing.shape[1])
+        self.SetNodalSpacing(spacing,borrow)
+
+    def ReadGmsh(self, str filename):
+        """Set up the linear mesh from a Gmsh MSH 4.1 file (ASCII or binary).
+        The element type is taken from the file and high order nodes are
+        re-ordered to PostMesh's ordering. Mesh points are not scaled, call
+        ScaleMesh afterwards if needed
+        """
+        cdef bytes fname = str.encode(filename)
+        self.baseptr.ReadGmsh(<const char*>fname)
+        self.ndim = self.baseptr.ndim
+
+    def ExtractBoundaryFaces(self):
+        """Derive the boundary faces of a tet/hex mesh from its elements"""
+        self.baseptr.ExtractBoundaryFaces()
+
+    def ExtractBoundaryEdges(self):
+        """Derive the boundary edges of a tri/quad mesh from its elements"""
+        self.baseptr.ExtractBoundaryEdges()
+
+    def ReadMeshBinary(self, str filename, verify=True):
+        """Set up the linear mesh from a binary mesh container written by
+        WriteMeshBinary. The file is memory mapped and no parsing takes place.
+        Mesh points are not scaled, call ScaleMesh afterwards if needed
+        """
+        cdef bytes fname = str.encode(filename)
+        self.baseptr.ReadMeshBinary(<const char*>fname, verify)
+
+    def WriteMeshBinary(self, str filename):
+        """Write the linear mesh that has been set up to a binary mesh container"""
+        cdef bytes fname = str.encode(filename)
+        self.baseptr.WriteMeshBinary(<const char*>fname)
+
+    def SetCADCacheDirectory(self, str directory):
+        """Cache translated CAD models and the data derived from them in directory,
+        keyed by the contents of the CAD file. Reading the same CAD file again then
+        skips the translation and extraction. An empty string disables the cache"""
+        cdef bytes dname = str.encode(directory)
+        self.baseptr.SetCADCacheDirectory(<const char*>dname)
 
     def ReadIGES(self, str filename):
         """Read IGES files"""
@@ -142,14 +341,52 @@ cdef class PostMeshBasePy:
         cdef bytes fname = str.encode(filename)
         self.baseptr.ReadSTEP(<const char*>fname)
 
+    def ReadBREP(self, str filename):
+        """Read OCC native BRep files. Much faster than IGES/STEP as
+        no translation is involved"""
+        cdef bytes fname = str.encode(filename)
+        self.baseptr.ReadBREP(<const char*>fname)
+
+    def SetShape(self, shape):
+        """Set the CAD model from a shape held in memory, given as BRep data [bytes or str],
+        i.e. the contents of a BRep file. An OCC shape can be passed this way after
+        serialising it with BRepTools::Write to a stream"""
+        cdef string brep
+        if isinstance(shape,str):
+            shape = str.encode(shape)
+        if not isinstance(shape,bytes):
+            raise TypeError("Shape should be given as BRep data [bytes or str]")
+        brep = shape
+        self.baseptr.ReadBREPString(brep)
+
+    def ReadCADFiles(self, filenames):
+        """Read an assembly given as a list of separate IGES, STEP or BRep part files.
+        BRep parts are read concurrently, IGES and STEP parts one at a time as their
+        translators are not thread-safe. The parts are merged into a single CAD model,
+        see GetSurfacesPartIDs and GetCurvesPartIDs for which part an entity came from"""
+        cdef vector[string] fnames
+        for filename in filenames:
+            fnames.push_back(str.encode(filename))
+        self.baseptr.ReadCADFiles(fnames)
+
+    def GetSurfacesPartIDs(self):
+        """Part (index into the list given to ReadCADFiles) of every CAD surface"""
+        cdef np.ndarray offsets = np.array(self.baseptr.parts_surfaces,dtype=np.int64)
+        return np.repeat(np.arange(max(offsets.shape[0]-1,0)),np.diff(offsets))
+
+    def GetCurvesPartIDs(self):
+        """Part (index into the list given to ReadCADFiles) of every CAD curve"""
+        cdef np.ndarray offsets = np.array(self.baseptr.parts_curves,dtype=np.int64)
+        return np.repeat(np.arange(max(offsets.shape[0]-1,0)),np.diff(offsets))
+
     @wraparound(True)
     def ReadGeometry(self, str filename):
-        """Read geometry from IGES or STEP files"""
+        """Read geometry from IGES, STEP or BRep files"""
         self.ReadCAD(filename)
 
     @wraparound(True)
     def ReadCAD(self, str filename):
-        """Read geometry from IGES or STEP files"""
+        """Read geometry from IGES, STEP or BRep files"""
         # GET THE CASE INSENSITIVE VERSION
         if getattr(str,'casefold',None) is not None:
             insen = lambda str_name: str_name.casefold()
@@ -162,6 +399,8 @@ cdef class PostMeshBasePy:
             self.baseptr.ReadIGES(<const char*>fname)
         if suffix == "step" or suffix == "stp":
             self.baseptr.ReadSTEP(<const char*>fname)
+        if suffix == "brep" or suffix == "brp":
+            self.baseptr.ReadBREP(<const char*>fname)
 
     def GetGeomVertices(self):
         self.baseptr.GetGeomVertices()
@@ -203,24 +442,70 @@ cdef class PostMeshBasePy:
         self.baseptr.GetGeomFaces()
         return geometry_points.reshape(int(geometry_points.shape[0]/self.ndim),self.ndim)
 
-    @boundscheck(False)
-    def GetDirichletData(self):
-        """Obtain Dirichlet boundary condition for higher order nodes of the mesh"""
-        cdef:
-            DirichletData struct_to_python = self.baseptr.GetDirichletData()
-            np.ndarray[np.int64_t, ndim=2, mode='c'] nodes_dir = np.zeros((struct_to_python.nodes_dir_size,1),dtype=np.int64)
-            Integer i
-            UInteger j
-
-        for i in range(struct_to_python.nodes_dir_size):
-            nodes_dir[i] = struct_to_python.nodes_dir_out_stl[i]
-
-        cdef np.ndarray[np.float64_t, ndim=2, mode='c'] displacements_BC = \
-            np.zeros((self.baseptr.ndim*struct_to_python.nodes_dir_size,1),dtype=np.float64)
-        for j in range(self.baseptr.ndim*struct_to_python.nodes_dir_size):
-            displacements_BC[j] = struct_to_python.displacement_BC_stl[j]
-
-        return nodes_dir, displacements_BC.reshape(struct_to_python.nodes_dir_size,self.baseptr.ndim)
+    def GetStats(self):
+        """Run statistics as a dict: inclusive wall time in seconds of every phase
+        (in the order the phases first ran), OCC projections by algorithm, failed
+        projections, mesh nodes snapped to CAD vertices, faces without a unique
+        surface and the peak resident set size of the process in bytes"""
+        cdef PostMeshStats stats = self.baseptr.GetStats()
+        phases = OrderedDict()
+        for phase in stats.phases:
+            phases[phase.first.decode()] = phase.second
+        return {"phases": phases,
+                "projections": {"point_on_curve": stats.projections_on_curve,
+                                "point_on_surface": stats.projections_on_surface,
+                                "extrema_on_surface": stats.extrema_on_surface,
+                                "newton_on_curve": stats.newton_on_curve},
+                "projection_failures": stats.projection_failures,
+                "vertex_snaps": stats.vertex_snaps,
+                "unresolved_faces": stats.unresolved_faces,
+                "peak_rss": stats.peak_rss}
+
+    def ResetStats(self):
+        """Clear the run statistics"""
+        self.baseptr.ResetStats()
+
+    def SetDiagnostics(self, callback=None, str filename=None, Integer max_examples=5, str level="warning"):
+        """Where the per node warnings of the projection phases go. Warnings are
+        aggregated by kind and written once at the end of every phase, with their
+        count and the details of the first max_examples of them. They are passed
+        to callback(phase, severity, kind, count, examples) if given, else appended
+        to filename if given, else printed to stderr. Messages below level, one of
+        info, warning or error, are dropped
+        """
+        if level not in _SEVERITIES:
+            raise ValueError("Unknown diagnostics level {}".format(level))
+        cdef bytes fname = str.encode(filename) if filename is not None else b""
+        self.baseptr.SetDiagnosticsLimits(max_examples, _SEVERITIES[level])
+        self.baseptr.SetDiagnosticsFile(<const char*>fname)
+        self.diagnostics_callback = callback
+        if callback is None:
+            self.baseptr.SetDiagnosticsCallback(NULL, NULL)
+        else:
+            self.baseptr.SetDiagnosticsCallback(_diagnostics_callback, <void*>callback)
+
+    def GetDirichletDataSize(self):
+        """Number of unique nodes with Dirichlet boundary condition"""
+        return self.baseptr.GetDirichletDataSize()
+
+    def GetDirichletData(self, Integer[:,::1] nodes_dir=None, Real[:,::1] displacements_BC=None):
+        """Obtain Dirichlet boundary condition for higher order nodes of the mesh.
+        The data is written straight into nodes_dir of shape (n,1) and displacements_BC
+        of shape (n,ndim), where n is GetDirichletDataSize(). These are allocated if
+        not given"""
+        cdef Integer n = self.baseptr.GetDirichletDataSize()
+        if nodes_dir is None:
+            nodes_dir = np.empty((n,1),dtype=np.int64)
+        if displacements_BC is None:
+            displacements_BC = np.empty((n,self.baseptr.ndim),dtype=np.float64)
+        if nodes_dir.shape[0] != n or nodes_dir.shape[1] != 1 or \
+            displacements_BC.shape[0] != n or displacements_BC.shape[1] != self.baseptr.ndim:
+            raise ValueError("Dirichlet data arrays must be of shape ({},1) and ({},{})".format(
+                n,n,self.baseptr.ndim))
+        if n > 0:
+            self.baseptr.FillDirichletData(&nodes_dir[0,0],&displacements_BC[0,0])
+
+        return nodes_dir.base, displacements_BC.base
 
 
     def __dealloc__(self):
@@ -341,6 +626,15 @@ cdef class PostMeshCurvePy(PostMeshBasePy):
         """
         (<PostMeshCurve*>self.baseptr).ReturnModifiedMeshPoints(&points[0,0])
 
+    def WriteVTU(self, str filename):
+        """Write the curved mesh, i.e. the mesh points with the Dirichlet
+        displacements applied, and the projected boundary edges to a binary
+        VTU file. Elements and edges are written as VTK Lagrange cells with
+        the curve ID and projection residual as cell data
+        """
+        cdef bytes fname = str.encode(filename)
+        (<PostMeshCurve*>self.baseptr).WriteVTU(<const char*>fname)
+
     def __dealloc__(self):
         # CREATE A TEMPORARY DERIVED CPP OBJECT
         cdef PostMeshCurve *tmpptr
@@ -593,6 +887,52 @@ cdef class PostMeshSurfacePy(PostMeshBasePy):
         return np.array(dirichlet_faces,
             copy=False).reshape(dirichlet_faces.size()/(self.ndim+1),self.ndim+1)
 
+    def WriteVTU(self, str filename):
+        """Write the curved mesh, i.e. the mesh points with the Dirichlet
+        displacements applied, and the projected boundary faces to a binary
+        VTU file. Elements and faces are written as VTK Lagrange cells with
+        the surface ID and projection residual as cell data
+        """
+        cdef bytes fname = str.encode(filename)
+        (<PostMeshSurface*>self.baseptr).WriteVTU(<const char*>fname)
+
+    def GetSurfaceProfile(self, str sort_by="time"):
+        """Cost profile of every CAD surface as a numpy record array, most expensive
+        surface first. sort_by is one of time, identification_time, projection_time,
+        inversion_time, projections, failures, extrema or residual. Times are wall
+        times in seconds spent in OCC calls on the surface, mean_extrema is the mean
+        number of extrema found per Extrema_ExtPS call and worst_residual the largest
+        distance a mesh node was moved to reach the surface. Surface types are
+        GeomAbs_SurfaceType values. The array can be re-sorted on any field with np.sort
+        """
+        cdef PostMeshStats stats = self.baseptr.GetStats()
+        cdef Integer nsurfaces = self.baseptr.NbSurfaces()
+        if nsurfaces > 0:
+            stats.Surface(nsurfaces-1)
+        cdef vector[Integer] order = stats.SurfaceOrder(str.encode(sort_by))
+        cdef SurfaceCost cost
+        cdef Integer i, isurface
+
+        costs = np.zeros(order.size(), dtype=[("surface",np.int64), ("type",np.int64),
+            ("total_time",np.float64), ("identification_time",np.float64),
+            ("projection_time",np.float64), ("inversion_time",np.float64),
+            ("projections",np.int64), ("failures",np.int64),
+            ("mean_extrema",np.float64), ("worst_residual",np.float64)])
+        for i in range(order.size()):
+            isurface = order[i]
+            cost = stats.surfaces[isurface]
+            costs[i] = (isurface, self.baseptr.SurfaceType(isurface) if isurface < nsurfaces else -1,
+                cost.TotalTime(), cost.identification_time, cost.projection_time, cost.inversion_time,
+                cost.projections, cost.failures, cost.MeanExtremaSolutions(), cost.worst_residual)
+        return costs
+
+    def WriteSurfaceProfile(self, str filename, str sort_by="time"):
+        """Write the cost profile of every CAD surface to a CSV file, most
+        expensive surface first. See GetSurfaceProfile for the columns and sort keys
+        """
+        cdef bytes fname = str.encode(filename)
+        (<PostMeshSurface*>self.baseptr).WriteSurfaceProfile(<const char*>fname, str.encode(sort_by))
+
     def __dealloc__(self):
         # CREATE A TEMPORARY DERIVED CPP OBJECT
         cdef PostMeshSurface *tmpptr
@@ -17,10 +17,10 @@ int main()
   std::string edge_file = cpath+"leaf_edges.dat";
 
   // PostMesh NEEDS ALL THIS INFORMATION A PRIORI
-  Eigen::MatrixUI elements = PostMeshBase::ReadI(elem_file,',');
+  Eigen::MatrixIndexUI elements = PostMeshBase::ReadI(elem_file,',');
   Eigen::MatrixR points = PostMeshBase::ReadR(point_file,',');
-  Eigen::MatrixUI edges = PostMeshBase::ReadI(edge_file,',');
-  Eigen::MatrixUI faces = Eigen::MatrixUI::Zero(1,4);
+  Eigen::MatrixIndexUI edges = PostMeshBase::ReadI(edge_file,',');
+  Eigen::MatrixIndexUI faces = Eigen::MatrixIndexUI::Zero(1,4);
 
 
   // NODAL SPACING OF POINTS IN THE REFRERENCE TRIANGLE (GAUSS-LOBATTO SPACING IN THS CASE)
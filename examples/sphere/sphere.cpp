@@ -18,10 +18,10 @@ int main()
   std::string face_file = cpath+"sphere_faces.dat";
 
   // PostMesh NEEDS ALL THIS INFORMATION A PRIORI
-  Eigen::MatrixUI elements = PostMeshBase::ReadI(elem_file,',');
+  Eigen::MatrixIndexUI elements = PostMeshBase::ReadI(elem_file,',');
   Eigen::MatrixR points = PostMeshBase::ReadR(point_file,',');
-  Eigen::MatrixUI edges = PostMeshBase::ReadI(edge_file,',');
-  Eigen::MatrixUI faces = PostMeshBase::ReadI(face_file,',');
+  Eigen::MatrixIndexUI edges = PostMeshBase::ReadI(edge_file,',');
+  Eigen::MatrixIndexUI faces = PostMeshBase::ReadI(face_file,',');
 
   // NODAL SPACING OF POINTS IN THE REFRERENCE TRIANGLE (FEKETE POINT SPACING IN THS CASE)
   std::string spacing_file = cpath+"nodal_spacing_p4.dat";
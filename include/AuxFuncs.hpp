@@ -7,6 +7,7 @@
 #endif
 
 #include <OCC_INC.hpp>
+#include <PostMeshTrace.hpp>
 
 //! AUXILARY FUNCTIONS FOR POSTMESH
 ALWAYS_INLINE std::vector<std::string> &split(const std::string &s, char delim, std::vector<std::string> &elems) {
@@ -294,6 +295,82 @@ double timeit(T (*func)(Params...), Args&&...args)
 }
 
 
+ALWAYS_INLINE Integer GetNumberOfThreads()
+{
+    //! NUMBER OF WORKER THREADS USED BY POSTMESH. CAN BE OVERRIDDEN
+    //! THROUGH THE POSTMESH_NUM_THREADS ENVIRONMENT VARIABLE, UP TO FOUR
+    //! THREADS PER HARDWARE THREAD
+    const Integer hardware = std::max(static_cast<Integer>(std::thread::hardware_concurrency()),Integer(1));
+    const char *env = std::getenv("POSTMESH_NUM_THREADS");
+    if (env != nullptr)
+    {
+        const Integer requested = std::atoll(env);
+        if (requested > 0) return std::min(requested,4*hardware);
+    }
+    return hardware;
+}
+
+template<typename Func>
+inline void parallel_for(Integer begin, Integer end, Func &&func, Integer min_block=1)
+{
+    //! SPLIT [begin,end) INTO CONTIGUOUS BLOCKS AND CALL func(lo,hi) ON EACH
+    //! BLOCK FROM A SEPARATE THREAD. BLOCKS ARE AT LEAST min_block LONG, SO
+    //! SMALL RANGES RUN ON THE CALLING THREAD WITHOUT SPAWNING ANYTHING.
+    //! THE FIRST EXCEPTION THROWN BY A WORKER IS RE-THROWN TO THE CALLER
+    const Integer n = end - begin;
+    if (n <= 0) return;
+
+    Integer nblocks = std::min(GetNumberOfThreads(), (n + min_block - 1)/std::max(min_block,Integer(1)));
+    if (nblocks <= 1)
+    {
+        PostMeshTraceScope trace("parallel_for","block",begin,end);
+        func(begin,end);
+        return;
+    }
+
+    std::exception_ptr error = nullptr;
+    std::mutex error_mutex;
+    auto worker = [&](Integer lo, Integer hi) {
+        try {
+            PostMeshTraceScope trace("parallel_for","block",lo,hi);
+            func(lo,hi);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    Integer spawned = 1;
+    try
+    {
+        threads.reserve(nblocks-1);
+        for (; spawned<nblocks; ++spawned)
+        {
+            threads.emplace_back(worker, begin + n*spawned/nblocks, begin + n*(spawned+1)/nblocks);
+        }
+    }
+    catch (...)
+    {
+        //! A THREAD COULD NOT BE STARTED. FINISH THE REMAINING BLOCKS HERE AND
+        //! JOIN THE RUNNING THREADS BEFORE RE-THROWING, AS DESTROYING A
+        //! JOINABLE THREAD TERMINATES THE PROCESS
+        for (Integer t=spawned; t<nblocks; ++t)
+        {
+            worker(begin + n*t/nblocks, begin + n*(t+1)/nblocks);
+        }
+        worker(begin, begin + n/nblocks);
+        for (auto &thread: threads) thread.join();
+        throw;
+    }
+    worker(begin, begin + n/nblocks);
+    for (auto &thread: threads) thread.join();
+
+    if (error) std::rethrow_exception(error);
+}
+
+
 ALWAYS_INLINE std::string getcwdpath(void)
 {
   char cpath[FILENAME_MAX];
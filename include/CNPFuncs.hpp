@@ -3,6 +3,11 @@
 
 #include <EIGEN_INC.hpp>
 #include <OCC_INC.hpp>
+#include <AuxFuncs.hpp>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <type_traits>
 
 template<typename T> struct unique_container
 {
@@ -37,11 +42,11 @@ arange(T b=1)
 }
 
 template<typename T, typename U, typename V>
-STATIC ALWAYS_INLINE T
-take(const Eigen::PlainObjectBase<T> &arr, const Eigen::PlainObjectBase<U> &arr_row, const Eigen::PlainObjectBase<V> &arr_col)
+STATIC ALWAYS_INLINE typename T::PlainObject
+take(const Eigen::DenseBase<T> &arr, const Eigen::PlainObjectBase<U> &arr_row, const Eigen::PlainObjectBase<V> &arr_col)
 {
     //! TAKE OUT PART OF A 2D ARRAY. MAKES A COPY
-    T arr_reduced;
+    typename T::PlainObject arr_reduced;
     arr_reduced.setZero(arr_row.rows(),arr_col.rows());
 
     for (auto i=0; i<arr_row.rows();i++)
@@ -76,6 +81,36 @@ STATIC ALWAYS_INLINE T take(const Eigen::PlainObjectBase<T> &arr, const Eigen::M
     return arr_reduced;
 }
 
+template<typename T, typename Index>
+STATIC Eigen::Matrix<typename T::Scalar,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>
+take_rows(const Eigen::DenseBase<T> &arr, const Index *rows, Integer no_rows, bool ravel=false)
+{
+    //! GATHER WHOLE ROWS OF A 2D ARRAY IN A SINGLE COPY, OPTIONALLY RAVELLED
+    //! INTO A COLUMN. REPLACES take WITH AN arange OF ALL COLUMNS
+    const Integer cols = arr.cols();
+    Eigen::Matrix<typename T::Scalar,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> arr_reduced;
+    if (ravel) arr_reduced.resize(no_rows*cols,1);
+    else arr_reduced.resize(no_rows,cols);
+
+    typename T::Scalar *out = arr_reduced.data();
+    for (Integer i=0; i<no_rows; ++i)
+    {
+        for (Integer j=0; j<cols; ++j)
+        {
+            out[i*cols+j] = arr(rows[i],j);
+        }
+    }
+
+    return arr_reduced;
+}
+
+template<typename T, typename Index>
+STATIC ALWAYS_INLINE Eigen::Matrix<typename T::Scalar,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>
+take_rows(const Eigen::DenseBase<T> &arr, const std::vector<Index> &rows, bool ravel=false)
+{
+    return take_rows(arr,rows.data(),rows.size(),ravel);
+}
+
 template<typename T, typename U>
 void STATIC put(Eigen::PlainObjectBase<T> &arr_to_put, const Eigen::PlainObjectBase<T> &arr_to_take,
                 const Eigen::PlainObjectBase<U> &arr_row, const Eigen::PlainObjectBase<U> &arr_col)
@@ -130,6 +165,186 @@ STATIC std::vector<Integer> argsort(const std::vector<T> &v)
     return idx;
 }
 
+struct uint128_key
+{
+    //! 128-BIT SORT KEY FOR RADIX SORTING, COMPARED AS (hi,lo)
+    std::uint64_t hi;
+    std::uint64_t lo;
+
+    ALWAYS_INLINE bool operator==(const uint128_key &other) const
+    {
+        return hi==other.hi && lo==other.lo;
+    }
+    ALWAYS_INLINE bool operator!=(const uint128_key &other) const
+    {
+        return !(*this==other);
+    }
+    ALWAYS_INLINE bool operator<(const uint128_key &other) const
+    {
+        return hi<other.hi || (hi==other.hi && lo<other.lo);
+    }
+};
+
+STATIC ALWAYS_INLINE unsigned radix_digit(std::uint64_t key, Integer pass)
+{
+    return static_cast<unsigned>((key >> (8*pass)) & 0xFF);
+}
+
+STATIC ALWAYS_INLINE unsigned radix_digit(const uint128_key &key, Integer pass)
+{
+    return pass<8 ? static_cast<unsigned>((key.lo >> (8*pass)) & 0xFF) :
+                    static_cast<unsigned>((key.hi >> (8*(pass-8))) & 0xFF);
+}
+
+template<typename Key>
+STATIC std::vector<Integer> radix_argsort(const std::vector<Key> &keys)
+{
+    //! STABLE ARGSORT OF UNSIGNED 64 OR 128-BIT KEYS. LSD RADIX SORT WITH
+    //! 8-BIT DIGITS, WHERE EVERY PASS IS SPLIT INTO CONTIGUOUS CHUNKS THAT
+    //! ARE HISTOGRAMMED AND SCATTERED CONCURRENTLY. PASSES OVER DIGITS
+    //! THAT ARE THE SAME FOR ALL KEYS (E.G. UNUSED HIGH BITS) ARE SKIPPED
+    const Integer n = keys.size();
+    std::vector<Integer> idx(n), idx_tmp(n);
+    std::iota(idx.begin(),idx.end(),0);
+    if (n<2) return idx;
+
+    std::vector<Key> work(keys), work_tmp(n);
+    const Integer nchunks = std::max(Integer(1),std::min(GetNumberOfThreads(),n/(Integer(1)<<16)));
+    std::vector<std::array<Integer,256>> histogram(nchunks), offsets(nchunks);
+
+    for (Integer pass=0; pass<Integer(sizeof(Key)); ++pass)
+    {
+        parallel_for(0,nchunks,[&](Integer lo, Integer hi) {
+            for (Integer t=lo; t<hi; ++t)
+            {
+                histogram[t].fill(0);
+                for (Integer i=n*t/nchunks; i<n*(t+1)/nchunks; ++i)
+                    ++histogram[t][radix_digit(work[i],pass)];
+            }
+        });
+
+        // SKIP THE PASS IF ALL KEYS SHARE THIS DIGIT
+        const unsigned first_digit = radix_digit(work[0],pass);
+        Integer same = 0;
+        for (Integer t=0; t<nchunks; ++t) same += histogram[t][first_digit];
+        if (same==n) continue;
+
+        Integer running = 0;
+        for (Integer d=0; d<256; ++d)
+        {
+            for (Integer t=0; t<nchunks; ++t)
+            {
+                offsets[t][d] = running;
+                running += histogram[t][d];
+            }
+        }
+
+        parallel_for(0,nchunks,[&](Integer lo, Integer hi) {
+            for (Integer t=lo; t<hi; ++t)
+            {
+                std::array<Integer,256> &offset = offsets[t];
+                for (Integer i=n*t/nchunks; i<n*(t+1)/nchunks; ++i)
+                {
+                    const Integer target = offset[radix_digit(work[i],pass)]++;
+                    work_tmp[target] = work[i];
+                    idx_tmp[target] = idx[i];
+                }
+            }
+        });
+        std::swap(work,work_tmp);
+        std::swap(idx,idx_tmp);
+    }
+
+    return idx;
+}
+
+template<typename T>
+STATIC ALWAYS_INLINE typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value,std::uint64_t>::type
+radix_key(T value)
+{
+    //! ORDER PRESERVING MAP OF A VALUE ONTO AN UNSIGNED 64-BIT RADIX KEY
+    return static_cast<std::uint64_t>(value);
+}
+
+template<typename T>
+STATIC ALWAYS_INLINE typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,std::uint64_t>::type
+radix_key(T value)
+{
+    // FLIP THE SIGN BIT SO THAT NEGATIVE VALUES COME FIRST
+    return static_cast<std::uint64_t>(static_cast<std::int64_t>(value)) ^ (std::uint64_t(1) << 63);
+}
+
+template<typename T>
+STATIC ALWAYS_INLINE typename std::enable_if<std::is_floating_point<T>::value,std::uint64_t>::type
+radix_key(T value)
+{
+    // IEEE-754: FLIP ALL BITS OF NEGATIVE VALUES AND THE SIGN BIT OF THE REST
+    const double real = value;
+    std::uint64_t bits;
+    std::memcpy(&bits,&real,sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | (std::uint64_t(1) << 63);
+}
+
+// BELOW THIS SIZE A MERGE SORT BEATS THE FIXED COST OF RADIX SORTING
+#define POSTMESH_RADIX_CUTOFF 256
+
+template<typename T, bool = std::is_arithmetic<T>::value>
+struct stable_argsort_impl
+{
+    static std::vector<Integer> run(const T *data, Integer n)
+    {
+        std::vector<Integer> idx(n);
+        std::iota(idx.begin(),idx.end(),0);
+        std::stable_sort(idx.begin(),idx.end(),[data](Integer i1, Integer i2) {return data[i1] < data[i2];});
+        return idx;
+    }
+};
+
+template<typename T>
+struct stable_argsort_impl<T,true>
+{
+    static std::vector<Integer> run(const T *data, Integer n)
+    {
+        if (n < POSTMESH_RADIX_CUTOFF)
+            return stable_argsort_impl<T,false>::run(data,n);
+        std::vector<std::uint64_t> keys(n);
+        for (Integer i=0; i<n; ++i)
+            keys[i] = radix_key(data[i]);
+        return radix_argsort(keys);
+    }
+};
+
+template<typename T>
+STATIC ALWAYS_INLINE std::vector<Integer> stable_argsort(const T *data, Integer n)
+{
+    //! STABLE ARGSORT, I.E. EQUAL VALUES KEEP THEIR ORDER. LARGE ARRAYS OF
+    //! INTEGERS AND REALS ARE RADIX SORTED, ANYTHING ELSE IS MERGE SORTED
+    return stable_argsort_impl<T>::run(data,n);
+}
+
+template<typename T>
+STATIC void unique_runs(const T *data, Integer n, std::vector<T> &uniques,
+                        std::vector<Integer> *first=nullptr, std::vector<Integer> *counts=nullptr)
+{
+    //! SORTED UNIQUE VALUES OF AN ARRAY, OPTIONALLY WITH THE INDEX OF THE
+    //! FIRST OCCURRENCE AND THE NUMBER OF OCCURRENCES OF EVERY VALUE. O(N)
+    //! FOR LARGE INTEGER/REAL ARRAYS, O(N LOG N) OTHERWISE
+    const std::vector<Integer> sorter = stable_argsort(data,n);
+    uniques.clear();
+    if (first) first->clear();
+    if (counts) counts->clear();
+    for (Integer i=0; i<n; ++i)
+    {
+        if (i==0 || !(data[sorter[i]]==data[sorter[i-1]]))
+        {
+            uniques.push_back(data[sorter[i]]);
+            if (first) first->push_back(sorter[i]);
+            if (counts) counts->push_back(0);
+        }
+        if (counts) ++counts->back();
+    }
+}
+
 template<typename T>
 STATIC ALWAYS_INLINE void sort_rows(std::vector<std::vector<T>> &arr)
 {
@@ -147,20 +362,114 @@ STATIC ALWAYS_INLINE void sort_rows(Eigen::MatrixBase<T> &arr)
     }
 }
 
+template<typename T>
+STATIC ALWAYS_INLINE void compare_swap(T *values, Integer *indices, Integer i, Integer j)
+{
+    //! ORDER values[i] AND values[j], CARRYING THEIR INDICES ALONG IF GIVEN
+    if (values[j] < values[i])
+    {
+        std::swap(values[i],values[j]);
+        if (indices) std::swap(indices[i],indices[j]);
+    }
+}
+
+template<Integer N> struct sorting_network;
+
+template<> struct sorting_network<2>
+{
+    template<typename T>
+    static ALWAYS_INLINE void sort(T *values, Integer *indices=nullptr)
+    {
+        compare_swap(values,indices,0,1);
+    }
+};
+
+template<> struct sorting_network<3>
+{
+    template<typename T>
+    static ALWAYS_INLINE void sort(T *values, Integer *indices=nullptr)
+    {
+        compare_swap(values,indices,0,1);
+        compare_swap(values,indices,1,2);
+        compare_swap(values,indices,0,1);
+    }
+};
+
+template<> struct sorting_network<4>
+{
+    template<typename T>
+    static ALWAYS_INLINE void sort(T *values, Integer *indices=nullptr)
+    {
+        compare_swap(values,indices,0,1);
+        compare_swap(values,indices,2,3);
+        compare_swap(values,indices,0,2);
+        compare_swap(values,indices,1,3);
+        compare_swap(values,indices,1,2);
+    }
+};
+
+template<Integer N, typename T>
+STATIC void sort_rows_network(Eigen::PlainObjectBase<T> &arr, Eigen::MatrixI &idx)
+{
+    //! SORTS EVERY ROW OF AN N-COLUMN ARRAY WITH A SORTING NETWORK, KEEPING
+    //! THE ROW AND ITS PERMUTATION IN LOCAL ARRAYS
+    for (Integer i=0; i<arr.rows(); ++i)
+    {
+        typename Eigen::PlainObjectBase<T>::Scalar values[N];
+        Integer indices[N];
+        for (Integer j=0; j<N; ++j)
+        {
+            values[j] = arr(i,j);
+            indices[j] = j;
+        }
+        sorting_network<N>::sort(values,indices);
+        for (Integer j=0; j<N; ++j)
+        {
+            arr(i,j) = values[j];
+            idx(i,j) = indices[j];
+        }
+    }
+}
+
+template<Integer N, typename T>
+STATIC void sort_back_rows_network(Eigen::PlainObjectBase<T> &arr, const Eigen::MatrixI &idx)
+{
+    //! UNDOES sort_rows_network GIVEN THE PERMUTATION IT RETURNED
+    for (Integer i=0; i<arr.rows(); ++i)
+    {
+        typename Eigen::PlainObjectBase<T>::Scalar values[N];
+        for (Integer j=0; j<N; ++j)
+            values[j] = arr(i,j);
+        for (Integer j=0; j<N; ++j)
+            arr(i,idx(i,j)) = values[j];
+    }
+}
+
 template<typename T>
 STATIC void sort_rows(Eigen::PlainObjectBase<T> &arr, Eigen::MatrixI &idx)
 {
-    //! SORTS A 2D ARRAY ROW BY ROW AND RETURN INDICES - IN-PLACE
+    //! SORTS A 2D ARRAY ROW BY ROW AND RETURN INDICES - IN-PLACE. ROWS OF 2, 3
+    //! OR 4 COLUMNS (EDGE AND FACE PARAMETERS) ARE SORTED WITH SORTING NETWORKS
+    assert (idx.rows()==arr.rows() && idx.cols()==arr.cols());
+    switch (arr.cols())
+    {
+    case 2: sort_rows_network<2>(arr,idx); return;
+    case 3: sort_rows_network<3>(arr,idx); return;
+    case 4: sort_rows_network<4>(arr,idx); return;
+    default: break;
+    }
+
+    std::vector<typename Eigen::PlainObjectBase<T>::Scalar> row_arr(arr.cols());
     for (auto i=0; i<arr.rows(); ++i)
     {
-        std::vector<Integer> row_indices;
-        std::vector<typename Eigen::PlainObjectBase<T>::Scalar> row_arr;
-        row_arr.assign(arr.row(i).data(),arr.row(i).data()+arr.row(i).size());
-        row_indices = argsort(row_arr);
-        idx.block(i,0,1,idx.cols()) = \
-                Eigen::Map<Eigen::MatrixI>(row_indices.data(),1,row_indices.size());
-        // SORT THE ACTUAL ARRAY NOW
-        std::sort(arr.row(i).data(),arr.row(i).data()+arr.row(i).size());
+        for (auto j=0; j<arr.cols(); ++j)
+            row_arr[j] = arr(i,j);
+        std::vector<Integer> row_indices = stable_argsort(row_arr.data(),arr.cols());
+        for (auto j=0; j<arr.cols(); ++j)
+        {
+            arr(i,j) = row_arr[row_indices[j]];
+            idx(i,j) = row_indices[j];
+        }
     }
 }
 
@@ -170,42 +479,73 @@ STATIC void sort_back_rows(Eigen::PlainObjectBase<T> &arr, const Eigen::MatrixI
     //! SORTS BACK THE ARRAY ROW-WISE TO ITS ORIGINAL SHAPE GIVEN THE SORT INDICES IDX.
     //! NO COPY INVOLVED
     assert (idx.rows()==arr.rows() && idx.cols()==arr.cols());
+    switch (arr.cols())
+    {
+    case 2: sort_back_rows_network<2>(arr,idx); return;
+    case 3: sort_back_rows_network<3>(arr,idx); return;
+    case 4: sort_back_rows_network<4>(arr,idx); return;
+    default: break;
+    }
 
+    std::vector<typename Eigen::PlainObjectBase<T>::Scalar> row_arr(arr.cols());
     for (auto i=0; i<arr.rows(); ++i)
     {
-        T current_row;
-        current_row.setZero(1,arr.cols());
         for (auto j=0; j<arr.cols(); ++j)
-        {
-            current_row(j) = arr(i,idx(i,j));
-        }
-        arr.block(i,0,1,arr.cols()) = current_row;
+            row_arr[j] = arr(i,j);
+        for (auto j=0; j<arr.cols(); ++j)
+            arr(i,idx(i,j)) = row_arr[j];
     }
 }
 
 template<typename T>
-STATIC ALWAYS_INLINE Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>
+STATIC ALWAYS_INLINE Eigen::Map<Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> >
 ravel(Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> &arr)
 {
-    //! RAVEL/FLATTEN THE ARRAY RESPECTING DATA CONTIGUOUSNESS. MAKES A COPY
+    //! RAVEL/FLATTEN THE ARRAY RESPECTING DATA CONTIGUOUSNESS. NO COPY, THE
+    //! RESULT IS A VIEW OF arr
     return Eigen::Map<Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> >
             (arr.data(),arr.rows()*arr.cols(),1);
 }
 
+template<typename T, typename U>
+STATIC ALWAYS_INLINE typename std::enable_if<std::is_integral<T>::value && std::is_integral<U>::value &&
+std::is_signed<T>::value==std::is_signed<U>::value,bool>::type
+equals(T value, U num, Real)
+{
+    //! EXACT COMPARISON OF INTEGERS
+    return value==num;
+}
+
+template<typename T, typename U>
+STATIC ALWAYS_INLINE typename std::enable_if<std::is_integral<T>::value && std::is_integral<U>::value &&
+std::is_signed<T>::value!=std::is_signed<U>::value,bool>::type
+equals(T value, U num, Real)
+{
+    // A NEGATIVE VALUE NEVER EQUALS AN UNSIGNED ONE
+    return !(value < T(0)) && !(num < U(0)) && static_cast<std::uint64_t>(value)==static_cast<std::uint64_t>(num);
+}
+
+template<typename T, typename U>
+STATIC ALWAYS_INLINE typename std::enable_if<!(std::is_integral<T>::value && std::is_integral<U>::value),bool>::type
+equals(T value, U num, Real tolerance)
+{
+    return Real( std::fabs((Real)value-num) ) < tolerance;
+}
+
 template<typename T, typename U = T>
 std::tuple<Eigen::MatrixUI,Eigen::MatrixUI >
-STATIC ALWAYS_INLINE where_eq(const Eigen::PlainObjectBase<T> &arr,
+STATIC ALWAYS_INLINE where_eq(const Eigen::DenseBase<T> &arr,
          U num, Real tolerance=1e-14)
 {
-    //! FIND THE OCCURENCES OF VALUE IN A MATRIX
+    //! FIND THE OCCURENCES OF VALUE IN A MATRIX. INTEGERS ARE COMPARED
+    //! EXACTLY, tolerance ONLY APPLIES TO FLOATING POINT VALUES
     std::vector<UInteger> idx_rows;
     std::vector<UInteger> idx_cols;
-    idx_rows.clear(); idx_cols.clear();
     for (Integer i=0; i<arr.rows();++i)
     {
         for (Integer j=0; j<arr.cols();++j)
         {
-            if (Real( std::fabs((Real)arr(i,j)-num) ) < tolerance)
+            if (equals(arr(i,j),num,tolerance))
             {
                 idx_rows.push_back(i);
                 idx_cols.push_back(j);
@@ -305,65 +645,26 @@ template<typename T>
 STATIC ALWAYS_INLINE std::tuple<std::vector<typename Eigen::PlainObjectBase<T>::Scalar>,std::vector<Integer> >
 unique(const Eigen::PlainObjectBase<T> &arr)
 {
-    //! RETURNS UNIQUE VALUES AND UNIQUE INDICES OF AN EIGEN MATRIX
+    //! RETURNS SORTED UNIQUE VALUES OF AN EIGEN MATRIX AND THE INDEX OF THEIR FIRST OCCURENCE
     assert(arr.cols()==1 && "UNIQUE_METHOD_IS_ONLY_AVAILABLE_FOR_1D_ARRAYS/MATRICES");
     std::vector<typename Eigen::PlainObjectBase<T>::Scalar> uniques;
     std::vector<Integer> idx;
+    unique_runs(arr.data(),arr.rows(),uniques,&idx);
 
-    for (auto i=0; i<arr.rows(); ++i) {
-        bool isunique = true;
-        for (auto j=0; j<=i; ++j) {
-            if (arr(i)==arr(j) && i!=j) {
-                isunique = false;
-                break;
-            }
-        }
-
-        if (isunique==true) {
-            uniques.push_back(arr(i));
-            idx.push_back(i);
-        }
-    }
-
-    // SORT UNIQUE VALUES
-    auto sorter = argsort(uniques);
-    std::sort(uniques.begin(),uniques.end());
-    std::vector<Integer> idx_sorted(idx.size());
-    for (UInteger i=0; i<uniques.size();++i) {
-        idx_sorted[i] = idx[sorter[i]];
-    }
-
-    std::tuple<std::vector<typename Eigen::PlainObjectBase<T>::Scalar>,std::vector<Integer> >
-            uniques_idx = std::make_tuple(uniques,idx_sorted);
-
-    return uniques_idx;
+    return std::make_tuple(uniques,idx);
 }
 
 template<typename T>
 STATIC ALWAYS_INLINE std::tuple<std::vector<T>,std::vector<Integer> >
 unique(const std::vector<T> &v, bool return_index=false)
 {
-    //! RETURNS UNIQUE VALUES AND UNIQUE INDICES OF A STD::VECTOR
-    if (return_index == false) {
-        std::vector<T> uniques(v.begin(),v.end());
-        std::sort(uniques.begin(),uniques.end());
-        uniques.erase(std::unique(uniques.begin(),uniques.end()),uniques.end());
-
-        return std::make_tuple(uniques,std::vector<Integer>(0));
-    }
-
-    auto sorter = argsort(v);
-    auto last = std::unique(sorter.begin(),sorter.end(),[&v](T a, T b){return v[a]==v[b];});
-    sorter.erase(last,sorter.end());
-
-    std::vector<T> uniques(sorter.size());
-    auto counter = 0;
-    for (auto &k: sorter) {
-        uniques[counter] = v[k];
-        counter++;
-    }
+    //! RETURNS SORTED UNIQUE VALUES OF A STD::VECTOR AND, IF REQUESTED, THE
+    //! INDEX OF THEIR FIRST OCCURENCE
+    std::vector<T> uniques;
+    std::vector<Integer> idx;
+    unique_runs(v.data(),v.size(),uniques,return_index ? &idx : nullptr);
 
-    return std::make_tuple(uniques,sorter);
+    return std::make_tuple(uniques,idx);
 }
 
 template<typename T>
@@ -372,17 +673,14 @@ itemfreq(const Eigen::PlainObjectBase<T> &arr)
 {
     //! FINDS THE NUMBER OF OCCURENCE OF EACH VALUE IN AN EIGEN MATRIX
     std::vector<typename Eigen::PlainObjectBase<T>::Scalar> uniques;
-    std::tie(uniques,std::ignore) = unique(arr);
-    Eigen::Matrix<typename Eigen::PlainObjectBase<T>::Scalar,DYNAMIC,DYNAMIC> freqs;
-    freqs.setZero(uniques.size(),2);
+    std::vector<Integer> counts;
+    unique_runs(arr.data(),arr.rows(),uniques,nullptr,&counts);
 
-    auto counter = 0;
-    for (auto &i: uniques)
+    Eigen::Matrix<typename Eigen::PlainObjectBase<T>::Scalar,DYNAMIC,DYNAMIC> freqs(uniques.size(),2);
+    for (UInteger i=0; i<uniques.size(); ++i)
     {
-        Integer counts = std::count(arr.data(),arr.data()+arr.rows(),i);
-        freqs(counter,0) = i;
-        freqs(counter,1) = counts;
-        counter++;
+        freqs(i,0) = uniques[i];
+        freqs(i,1) = counts[i];
     }
 
     return freqs;
@@ -394,16 +692,14 @@ Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> itemfreq(const std::vector<T>
 {
     //! FINDS THE NUMBER OF OCCURENCE OF EACH VALUE IN A VECTOR
     std::vector<T> uniques;
-    std::tie(uniques,std::ignore) = unique(arr,false);
-    Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> freqs(uniques.size(),2);
+    std::vector<Integer> counts;
+    unique_runs(arr.data(),arr.size(),uniques,nullptr,&counts);
 
-    auto counter = 0;
-    for (auto &i: uniques)
+    Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> freqs(uniques.size(),2);
+    for (UInteger i=0; i<uniques.size(); ++i)
     {
-        Integer counts = std::count(arr.begin(),arr.end(),i);
-        freqs(counter,0) = i;
-        freqs(counter,1) = counts;
-        counter++;
+        freqs(i,0) = uniques[i];
+        freqs(i,1) = counts[i];
     }
 
     return freqs;
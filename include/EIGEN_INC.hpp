@@ -39,6 +39,125 @@ typedef Eigen::Matrix<Integer,1,DYNAMIC,POSTMESH_ALIGNED> RowVectorI;
 typedef Eigen::Matrix<Real,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixR;
 typedef Eigen::Matrix<Integer,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixI;
 typedef Eigen::Matrix<UInteger,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixUI;
+// CONNECTIVITY AND NODE BOOKKEEPING, SEE IndexI/IndexUI
+typedef Eigen::Matrix<IndexI,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixIndexI;
+typedef Eigen::Matrix<IndexUI,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixIndexUI;
+
+
+// A ROW-MAJOR MATRIX THAT EITHER OWNS ITS STORAGE OR BORROWS A BUFFER OWNED
+// BY THE CALLER (E.G. A NUMPY ARRAY OR A MAPPED FILE) WITHOUT COPYING IT.
+// LIFETIME CONTRACT: A BORROWED BUFFER MUST OUTLIVE EVERY OBJECT (AND COPY
+// OF AN OBJECT) THAT REFERS TO IT AND MUST NOT BE MODIFIED BY THE CALLER
+// IN THE MEANTIME. BORROWED BUFFERS ARE NEVER FREED; THEY ARE ALSO NEVER
+// WRITTEN TO, PROVIDED IN-PLACE UPDATES ARE PRECEDED BY MakeWritable,
+// WHICH COPIES THE BUFFER INTO OWNED STORAGE ON FIRST WRITE. ASSIGNING
+// AN EXPRESSION ALWAYS RESULTS IN OWNED STORAGE
+template<typename T>
+class BorrowableMatrix : public Eigen::Map<Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> >
+{
+public:
+    typedef Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> PlainMatrix;
+    typedef Eigen::Map<PlainMatrix> Base;
+
+    BorrowableMatrix() : Base(nullptr,0,0), borrowed(false) {}
+
+    BorrowableMatrix(const BorrowableMatrix &other) : Base(nullptr,0,0), borrowed(false)
+    {
+        *this = other;
+    }
+
+    BorrowableMatrix(BorrowableMatrix &&other) noexcept : Base(nullptr,0,0), borrowed(false)
+    {
+        *this = std::move(other);
+    }
+
+    BorrowableMatrix &operator=(const BorrowableMatrix &other)
+    {
+        //! OWNED DATA IS DEEP COPIED, BORROWED DATA STAYS BORROWED
+        if (this == &other) return *this;
+        if (other.borrowed)
+            this->Borrow(const_cast<T*>(other.data()),other.rows(),other.cols());
+        else
+            *this = PlainMatrix(other.storage);
+        return *this;
+    }
+
+    BorrowableMatrix &operator=(BorrowableMatrix &&other) noexcept
+    {
+        if (this == &other) return *this;
+        this->storage = std::move(other.storage);
+        this->borrowed = other.borrowed;
+        this->Reseat(this->borrowed ? other.data() : this->storage.data(),other.rows(),other.cols());
+        other.storage.resize(0,0);
+        other.borrowed = false;
+        other.Reseat(nullptr,0,0);
+        return *this;
+    }
+
+    BorrowableMatrix &operator=(PlainMatrix &&other)
+    {
+        this->storage = std::move(other);
+        this->borrowed = false;
+        this->Reseat(this->storage.data(),this->storage.rows(),this->storage.cols());
+        return *this;
+    }
+
+    template<typename OtherDerived>
+    BorrowableMatrix &operator=(const Eigen::DenseBase<OtherDerived> &other)
+    {
+        //! EVALUATE FIRST AS other MAY REFER TO THIS MATRIX
+        return *this = PlainMatrix(other);
+    }
+
+    void Borrow(T *data, Eigen::Index rows, Eigen::Index cols)
+    {
+        this->storage.resize(0,0);
+        this->borrowed = true;
+        this->Reseat(data,rows,cols);
+    }
+
+    void MakeWritable()
+    {
+        //! COPY ON FIRST WRITE
+        if (this->borrowed)
+            *this = PlainMatrix(static_cast<const Base&>(*this));
+    }
+
+    bool IsBorrowed() const
+    {
+        return this->borrowed;
+    }
+
+    void TruncateRows(Eigen::Index rows)
+    {
+        //! KEEP THE FIRST rows ROWS. A BORROWED BUFFER IS NARROWED IN O(1),
+        //! OWNED STORAGE IS SHRUNK IN PLACE WHERE THE ALLOCATOR ALLOWS
+        assert(rows <= this->rows());
+        if (!this->borrowed)
+        {
+            this->storage.conservativeResize(rows,Eigen::NoChange);
+            this->Reseat(this->storage.data(),rows,this->cols());
+        }
+        else
+        {
+            this->Reseat(this->data(),rows,this->cols());
+        }
+    }
+
+private:
+    void Reseat(T *data, Eigen::Index rows, Eigen::Index cols)
+    {
+        //! RE-POINT THE MAP, AS DOCUMENTED BY EIGEN
+        new (static_cast<Base*>(this)) Base(data,rows,cols);
+    }
+
+    PlainMatrix storage;
+    bool borrowed;
+};
+
+typedef BorrowableMatrix<Real> BorrowableMatrixR;
+typedef BorrowableMatrix<UInteger> BorrowableMatrixUI;
+typedef BorrowableMatrix<IndexUI> BorrowableMatrixIndexUI;
 
 
 #ifdef WRAP_DATA
@@ -0,0 +1,471 @@
+#ifndef GMSH_READER_HPP
+#define GMSH_READER_HPP
+
+#include <IOFuncs.hpp>
+#include <NodeArrangement.hpp>
+
+#include <unordered_map>
+
+
+// STREAMING READER FOR GMSH MSH 4.1 FILES (ASCII AND BINARY)
+namespace postmesh_io {
+
+struct GmshMesh
+{
+    //! A MESH AS READ FROM A GMSH FILE, WITH CONNECTIVITIES RENUMBERED
+    //! DENSELY FROM ZERO AND HIGH ORDER NODES IN POSTMESH ORDERING
+    std::string element_type;
+    Integer ndim = 0;
+    Integer degree = 0;
+    Eigen::MatrixIndexUI elements;
+    Eigen::MatrixR points;
+    Eigen::MatrixIndexUI faces;
+    Eigen::MatrixIndexUI edges;
+};
+
+inline bool GmshElementType(Integer gmsh_type, std::string &element_type, Integer &degree)
+{
+    //! MAP A GMSH ELEMENT TYPE TO A POSTMESH ELEMENT TYPE AND DEGREE.
+    //! RETURNS FALSE FOR TYPES POSTMESH DOES NOT HANDLE (POINTS, PRISMS,
+    //! PYRAMIDS AND INCOMPLETE/SERENDIPITY ELEMENTS)
+    static const std::map<Integer,std::pair<const char*,Integer>> types = {
+        {1,{"line",1}}, {8,{"line",2}}, {26,{"line",3}}, {27,{"line",4}}, {28,{"line",5}},
+        {62,{"line",6}}, {63,{"line",7}}, {64,{"line",8}}, {65,{"line",9}}, {66,{"line",10}},
+        {2,{"tri",1}}, {9,{"tri",2}}, {21,{"tri",3}}, {23,{"tri",4}}, {25,{"tri",5}},
+        {42,{"tri",6}}, {43,{"tri",7}}, {44,{"tri",8}}, {45,{"tri",9}}, {46,{"tri",10}},
+        {3,{"quad",1}}, {10,{"quad",2}}, {36,{"quad",3}}, {37,{"quad",4}}, {38,{"quad",5}},
+        {47,{"quad",6}}, {48,{"quad",7}}, {49,{"quad",8}}, {50,{"quad",9}}, {51,{"quad",10}},
+        {4,{"tet",1}}, {11,{"tet",2}}, {29,{"tet",3}}, {30,{"tet",4}}, {31,{"tet",5}},
+        {71,{"tet",6}}, {72,{"tet",7}}, {73,{"tet",8}}, {74,{"tet",9}}, {75,{"tet",10}},
+        {5,{"hex",1}}, {12,{"hex",2}}, {92,{"hex",3}}, {93,{"hex",4}}, {94,{"hex",5}},
+        {95,{"hex",6}}, {96,{"hex",7}}, {97,{"hex",8}}, {98,{"hex",9}}};
+
+    auto it = types.find(gmsh_type);
+    if (it==types.end()) return false;
+    element_type = it->second.first;
+    degree = it->second.second;
+    return true;
+}
+
+inline Integer GmshUnsupportedElementNodes(Integer gmsh_type)
+{
+    //! NUMBER OF NODES OF ELEMENT TYPES THAT ARE SKIPPED, NEEDED TO SKIP
+    //! THEM IN BINARY FILES. RETURNS -1 FOR UNKNOWN TYPES
+    switch (gmsh_type)
+    {
+        case 15: return 1;
+        case 6: return 6;
+        case 7: return 5;
+        case 13: return 18;
+        case 14: return 14;
+        case 16: return 8;
+        case 17: return 20;
+        case 18: return 15;
+        case 19: return 13;
+        case 20: return 9;
+        case 22: return 12;
+        case 24: return 15;
+        default: return -1;
+    }
+}
+
+class GmshCursor
+{
+public:
+    //! READS ASCII TOKENS OR RAW BINARY VALUES FROM A MAPPED MSH FILE
+    ALWAYS_INLINE GmshCursor(const char *first, const char *last) \
+        : p(first), end(last), binary(false), size_bytes(sizeof(std::uint64_t)) {}
+
+    ALWAYS_INLINE void SkipWhitespace()
+    {
+        while (this->p<this->end && (is_blank(*this->p) || *this->p=='\n')) ++this->p;
+    }
+
+    inline bool NextSection(std::string &name)
+    {
+        //! ADVANCE TO THE NEXT LINE STARTING WITH '$' AND CONSUME IT
+        //! INCLUDING ITS NEW LINE
+        this->SkipWhitespace();
+        while (this->p<this->end && *this->p!='$')
+        {
+            const char *newline = static_cast<const char*>(std::memchr(this->p,'\n',this->end-this->p));
+            this->p = newline ? newline+1 : this->end;
+            this->SkipWhitespace();
+        }
+        if (this->p==this->end) return false;
+        const char *first = ++this->p;
+        while (this->p<this->end && !is_separator(*this->p,'\n')) ++this->p;
+        name.assign(first,this->p);
+        while (this->p<this->end && *this->p!='\n') ++this->p;
+        if (this->p<this->end) ++this->p;
+        return true;
+    }
+
+    inline void SkipSection(const std::string &name)
+    {
+        //! SKIP TO THE END OF AN UNINTERESTING SECTION
+        const std::string marker = "$End"+name;
+        const char *found = std::search(this->p,this->end,marker.begin(),marker.end());
+        if (found==this->end)
+            throw std::runtime_error("Unterminated section $"+name+" in Gmsh file");
+        this->p = found;
+        std::string section;
+        this->NextSection(section);
+    }
+
+    inline void EndSection(const std::string &name)
+    {
+        std::string section;
+        if (!this->NextSection(section) || section!="End"+name)
+            throw std::runtime_error("Expected $End"+name+" in Gmsh file");
+    }
+
+    ALWAYS_INLINE Integer ReadInt()
+    {
+        if (this->binary) {
+            std::int32_t value;
+            this->ReadRaw(&value,sizeof(value));
+            return value;
+        }
+        Integer value;
+        this->SkipWhitespace();
+        this->p = parse_integer(this->p,this->end,' ',value);
+        return value;
+    }
+
+    ALWAYS_INLINE Integer ReadSize()
+    {
+        if (this->binary) {
+            if (this->size_bytes==sizeof(std::uint64_t)) {
+                std::uint64_t value;
+                this->ReadRaw(&value,sizeof(value));
+                return static_cast<Integer>(value);
+            }
+            std::uint32_t value;
+            this->ReadRaw(&value,sizeof(value));
+            return static_cast<Integer>(value);
+        }
+        Integer value;
+        this->SkipWhitespace();
+        this->p = parse_integer(this->p,this->end,' ',value);
+        return value;
+    }
+
+    ALWAYS_INLINE Real ReadReal()
+    {
+        Real value;
+        if (this->binary) {
+            this->ReadRaw(&value,sizeof(value));
+            return value;
+        }
+        this->SkipWhitespace();
+        this->p = parse_real(this->p,this->end,' ',value);
+        return value;
+    }
+
+    ALWAYS_INLINE void ReadRaw(void *out, size_t nbytes)
+    {
+        if (this->p + nbytes > this->end)
+            throw std::runtime_error("Unexpected end of Gmsh file");
+        std::memcpy(out,this->p,nbytes);
+        this->p += nbytes;
+    }
+
+    ALWAYS_INLINE void SkipLine()
+    {
+        const char *newline = static_cast<const char*>(std::memchr(this->p,'\n',this->end-this->p));
+        this->p = newline ? newline+1 : this->end;
+    }
+
+    const char *p;
+    const char *end;
+    bool binary;
+    size_t size_bytes;
+};
+
+inline void ReadGmshFormat(GmshCursor &cursor)
+{
+    const Real version = cursor.ReadReal();
+    const Integer file_type = cursor.ReadInt();
+    const Integer data_size = cursor.ReadInt();
+    if (version < 4.1 - 1e-8 || version >= 5.)
+        throw std::runtime_error("Only Gmsh MSH 4.1 files are supported (gmsh -format msh41)");
+    cursor.SkipLine();
+    if (file_type==1)
+    {
+        cursor.binary = true;
+        cursor.size_bytes = static_cast<size_t>(data_size);
+        std::int32_t one;
+        cursor.ReadRaw(&one,sizeof(one));
+        if (one!=1)
+            throw std::runtime_error("Binary Gmsh file was written with a different byte order");
+    }
+    cursor.binary = false;
+    cursor.EndSection("MeshFormat");
+    cursor.binary = file_type==1;
+}
+
+inline void SkipGmshEntitiesBinary(GmshCursor &cursor)
+{
+    //! BINARY ENTITIES CANNOT BE SKIPPED BY SEARCHING FOR THE END MARKER,
+    //! SO THEY ARE WALKED THROUGH
+    Integer counts[4];
+    for (Integer d=0; d<4; ++d) counts[d] = cursor.ReadSize();
+    for (Integer d=0; d<4; ++d)
+    {
+        for (Integer i=0; i<counts[d]; ++i)
+        {
+            cursor.ReadInt();
+            for (Integer j=0; j<(d==0 ? 3 : 6); ++j) cursor.ReadReal();
+            const Integer nphysical = cursor.ReadSize();
+            for (Integer j=0; j<nphysical; ++j) cursor.ReadInt();
+            if (d>0) {
+                const Integer nbounding = cursor.ReadSize();
+                for (Integer j=0; j<nbounding; ++j) cursor.ReadInt();
+            }
+        }
+    }
+}
+
+class GmshNodeTags
+{
+public:
+    //! MAPS GMSH NODE TAGS TO DENSE ZERO-BASED INDICES. A LOOKUP TABLE IS
+    //! USED UNLESS THE TAGS ARE VERY SPARSE
+    ALWAYS_INLINE void Reserve(Integer nnodes, Integer max_tag)
+    {
+        this->dense = max_tag < 8*nnodes + 1024;
+        if (this->dense) this->table.assign(max_tag+1,-1);
+        else this->sparse.reserve(nnodes);
+    }
+
+    ALWAYS_INLINE void Insert(Integer tag, Integer index)
+    {
+        if (this->dense) {
+            if (tag<0 || tag>=Integer(this->table.size()))
+                throw std::runtime_error("Node tag out of declared range in Gmsh file");
+            this->table[tag] = index;
+        }
+        else {
+            this->sparse[tag] = index;
+        }
+    }
+
+    ALWAYS_INLINE IndexUI Find(Integer tag) const
+    {
+        Integer index = -1;
+        if (this->dense) {
+            if (tag>=0 && tag<Integer(this->table.size())) index = this->table[tag];
+        }
+        else {
+            auto it = this->sparse.find(tag);
+            if (it!=this->sparse.end()) index = it->second;
+        }
+        if (index<0)
+            throw std::runtime_error("Element refers to undefined node "+std::to_string(tag));
+        if (static_cast<UInteger>(index) > std::numeric_limits<IndexUI>::max())
+            throw std::overflow_error("Too many nodes for the index type of this build");
+        return static_cast<IndexUI>(index);
+    }
+
+private:
+    bool dense = true;
+    std::vector<Integer> table;
+    std::unordered_map<Integer,Integer> sparse;
+};
+
+struct GmshElementBlocks
+{
+    //! CONNECTIVITY OF ALL ELEMENTS OF ONE TYPE, ALREADY IN POSTMESH ORDERING
+    std::string element_type;
+    Integer degree = 0;
+    Integer nnodes = 0;
+    std::vector<IndexUI> connectivity;
+};
+
+inline GmshMesh ReadGmsh(const std::string &filename)
+{
+    //! READ A GMSH MSH 4.1 FILE IN A SINGLE PASS OVER THE MAPPED FILE. THE
+    //! ELEMENTS OF HIGHEST DIMENSION BECOME THE MESH ELEMENTS, THE ELEMENTS
+    //! ONE AND TWO DIMENSIONS LOWER BECOME FACES AND EDGES. NODES ARE
+    //! NUMBERED IN THE ORDER THEY APPEAR IN THE FILE
+    MappedFile file(filename);
+    if (!file.IsOpen())
+        throw std::runtime_error("Unable to read file "+filename);
+
+    GmshCursor cursor(file.begin(),file.end());
+    GmshMesh mesh;
+    GmshNodeTags node_tags;
+    Eigen::MatrixR points;
+    // ELEMENTS BY DIMENSION AND GMSH TYPE
+    std::map<Integer,GmshElementBlocks> blocks[4];
+    bool has_format = false;
+
+    std::string section;
+    while (cursor.NextSection(section))
+    {
+        if (section=="MeshFormat")
+        {
+            ReadGmshFormat(cursor);
+            has_format = true;
+        }
+        else if (!has_format)
+        {
+            throw std::runtime_error(filename+" is not a Gmsh MSH file");
+        }
+        else if (section=="Entities" && cursor.binary)
+        {
+            SkipGmshEntitiesBinary(cursor);
+            cursor.binary = false;
+            cursor.EndSection("Entities");
+            cursor.binary = true;
+        }
+        else if (section=="Nodes")
+        {
+            const Integer nblocks = cursor.ReadSize();
+            const Integer nnodes = cursor.ReadSize();
+            cursor.ReadSize();
+            const Integer max_tag = cursor.ReadSize();
+            node_tags.Reserve(nnodes,max_tag);
+            points.resize(nnodes,3);
+
+            Integer counter = 0;
+            std::vector<Integer> tags;
+            for (Integer iblock=0; iblock<nblocks; ++iblock)
+            {
+                const Integer entity_dim = cursor.ReadInt();
+                cursor.ReadInt();
+                const Integer parametric = cursor.ReadInt();
+                const Integer nblock_nodes = cursor.ReadSize();
+                if (counter + nblock_nodes > nnodes)
+                    throw std::runtime_error("More nodes than declared in Gmsh file");
+
+                for (Integer i=0; i<nblock_nodes; ++i)
+                    node_tags.Insert(cursor.ReadSize(),counter+i);
+
+                const Integer nparametric = parametric ? entity_dim : 0;
+                for (Integer i=0; i<nblock_nodes; ++i)
+                {
+                    points(counter+i,0) = cursor.ReadReal();
+                    points(counter+i,1) = cursor.ReadReal();
+                    points(counter+i,2) = cursor.ReadReal();
+                    for (Integer j=0; j<nparametric; ++j) cursor.ReadReal();
+                }
+                counter += nblock_nodes;
+            }
+            const bool binary = cursor.binary;
+            cursor.binary = false;
+            cursor.EndSection("Nodes");
+            cursor.binary = binary;
+        }
+        else if (section=="Elements")
+        {
+            const Integer nblocks = cursor.ReadSize();
+            cursor.ReadSize();
+            cursor.ReadSize();
+            cursor.ReadSize();
+
+            std::vector<IndexUI> gmsh_nodes;
+            for (Integer iblock=0; iblock<nblocks; ++iblock)
+            {
+                const Integer entity_dim = cursor.ReadInt();
+                cursor.ReadInt();
+                const Integer gmsh_type = cursor.ReadInt();
+                const Integer nelements = cursor.ReadSize();
+
+                std::string element_type;
+                Integer degree;
+                if (!GmshElementType(gmsh_type,element_type,degree) || entity_dim<1 || entity_dim>3)
+                {
+                    // SKIP ELEMENTS POSTMESH HAS NO USE FOR
+                    if (!cursor.binary) {
+                        cursor.SkipLine();
+                        for (Integer i=0; i<nelements; ++i) cursor.SkipLine();
+                        continue;
+                    }
+                    const Integer nnodes = GmshUnsupportedElementNodes(gmsh_type);
+                    if (nnodes<0)
+                        throw std::runtime_error("Unknown element type "+std::to_string(gmsh_type)+" in Gmsh file");
+                    std::vector<char> skip(nelements*(nnodes+1)*cursor.size_bytes);
+                    cursor.ReadRaw(skip.data(),skip.size());
+                    continue;
+                }
+
+                GmshElementBlocks &block = blocks[entity_dim][gmsh_type];
+                if (block.nnodes==0)
+                {
+                    block.element_type = element_type;
+                    block.degree = degree;
+                    block.nnodes = NbElementNodes(element_type,degree);
+                }
+                const std::vector<Integer> permutation = GmshToPostMeshPermutation(element_type,degree);
+                const Integer nnodes = block.nnodes;
+                gmsh_nodes.resize(nnodes);
+
+                size_t offset = block.connectivity.size();
+                block.connectivity.resize(offset + nelements*nnodes);
+                for (Integer i=0; i<nelements; ++i)
+                {
+                    cursor.ReadSize();
+                    for (Integer j=0; j<nnodes; ++j)
+                        gmsh_nodes[j] = node_tags.Find(cursor.ReadSize());
+                    for (Integer j=0; j<nnodes; ++j)
+                        block.connectivity[offset+j] = gmsh_nodes[permutation[j]];
+                    offset += nnodes;
+                }
+            }
+            const bool binary = cursor.binary;
+            cursor.binary = false;
+            cursor.EndSection("Elements");
+            cursor.binary = binary;
+        }
+        else if (section.compare(0,3,"End")!=0)
+        {
+            cursor.SkipSection(section);
+        }
+    }
+
+    if (!has_format)
+        throw std::runtime_error(filename+" is not a Gmsh MSH file");
+
+    Integer top_dim = 3;
+    while (top_dim>0 && blocks[top_dim].empty()) --top_dim;
+    if (top_dim<2)
+        throw std::runtime_error("No triangular, quadrilateral, tetrahedral or hexahedral elements in "+filename);
+
+    if (blocks[top_dim].size()>1)
+        throw std::runtime_error("Mixed element meshes are not supported by PostMesh");
+    const GmshElementBlocks &element_block = blocks[top_dim].begin()->second;
+
+    auto to_matrix = [](const GmshElementBlocks &block) {
+        return Eigen::MatrixIndexUI(Eigen::Map<const Eigen::MatrixIndexUI>(block.connectivity.data(),
+            block.connectivity.size()/block.nnodes,block.nnodes));
+    };
+    auto find_block = [&](Integer dim, const std::string &element_type) -> const GmshElementBlocks* {
+        for (auto &block: blocks[dim])
+            if (block.second.element_type==element_type && block.second.degree==element_block.degree)
+                return &block.second;
+        return nullptr;
+    };
+
+    mesh.element_type = element_block.element_type;
+    mesh.degree = element_block.degree;
+    mesh.ndim = top_dim;
+    mesh.elements = to_matrix(element_block);
+    mesh.points = points.leftCols(top_dim);
+
+    if (top_dim==3)
+    {
+        const GmshElementBlocks *faces = find_block(2,mesh.element_type=="tet" ? "tri" : "quad");
+        if (faces) mesh.faces = to_matrix(*faces);
+    }
+    const GmshElementBlocks *edges = find_block(1,"line");
+    if (edges) mesh.edges = to_matrix(*edges);
+
+    return mesh;
+}
+
+}
+// end of namespace
+
+#endif // GMSH_READER_HPP
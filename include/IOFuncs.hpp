@@ -0,0 +1,1069 @@
+#ifndef IO_FUNCS_HPP
+#define IO_FUNCS_HPP
+
+#ifndef EIGEN_INC_HPP
+#include <EIGEN_INC.hpp>
+#endif
+
+#include <AuxFuncs.hpp>
+
+#include <cstring>
+#include <cstdint>
+#include <cstdlib>
+
+#ifndef WINDOWS
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#else
+    #include <process.h>
+    #define getpid _getpid
+#endif
+
+
+// LOW-LEVEL FILE INGESTION FOR POSTMESH. FILES ARE MAPPED INTO MEMORY
+// AND TOKENISED IN PLACE WITHOUT ANY INTERMEDIATE STRINGS
+namespace postmesh_io {
+
+class MappedFile
+{
+public:
+    //! VIEW OVER THE CONTENTS OF A FILE. ON POSIX SYSTEMS THE FILE IS MAPPED
+    //! INTO MEMORY, OTHERWISE IT IS READ INTO AN OWNED BUFFER. A WRITABLE
+    //! MAPPING IS PRIVATE (COPY-ON-WRITE) SO THE FILE ITSELF IS NEVER MODIFIED.
+    //! NON-COPYABLE, THE MAPPING IS RELEASED ON DESTRUCTION
+
+    ALWAYS_INLINE MappedFile() : ptr(nullptr), nbytes(0), mapped(false) {}
+
+    ALWAYS_INLINE explicit MappedFile(const std::string &filename, bool writable=false) \
+        : ptr(nullptr), nbytes(0), mapped(false)
+    {
+        this->Open(filename,writable);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ALWAYS_INLINE ~MappedFile()
+    {
+        this->Close();
+    }
+
+    inline bool Open(const std::string &filename, bool writable=false)
+    {
+        this->Close();
+    #ifndef WINDOWS
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        this->nbytes = static_cast<size_t>(st.st_size);
+        if (this->nbytes > 0)
+        {
+            const int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+            void *addr = ::mmap(nullptr, this->nbytes, protection, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED) {
+                ::close(fd);
+                this->nbytes = 0;
+                return false;
+            }
+            // TEXT FILES ARE TRAVERSED FRONT TO BACK, BINARY ONES ARE HANDED OUT AS A WHOLE
+            ::madvise(addr, this->nbytes, writable ? MADV_WILLNEED : MADV_SEQUENTIAL);
+            this->ptr = static_cast<char*>(addr);
+            this->mapped = true;
+        }
+        ::close(fd);
+        this->is_open = true;
+        return true;
+    #else
+        (void)writable;
+        std::ifstream datafile(filename.c_str(), std::ios::binary);
+        if (!datafile) return false;
+        this->buffer.assign(std::istreambuf_iterator<char>(datafile), std::istreambuf_iterator<char>());
+        this->ptr = this->buffer.data();
+        this->nbytes = this->buffer.size();
+        this->is_open = true;
+        return true;
+    #endif
+    }
+
+    inline void Close()
+    {
+    #ifndef WINDOWS
+        if (this->mapped)
+            ::munmap(this->ptr, this->nbytes);
+    #else
+        std::vector<char>().swap(this->buffer);
+    #endif
+        this->ptr = nullptr;
+        this->nbytes = 0;
+        this->mapped = false;
+        this->is_open = false;
+    }
+
+    ALWAYS_INLINE bool IsOpen() const {return this->is_open;}
+    ALWAYS_INLINE const char* begin() const {return this->ptr;}
+    ALWAYS_INLINE char* data() {return this->ptr;}
+    ALWAYS_INLINE const char* end() const {return this->ptr + this->nbytes;}
+    ALWAYS_INLINE size_t size() const {return this->nbytes;}
+
+private:
+    char *ptr;
+    size_t nbytes;
+    bool mapped;
+    bool is_open = false;
+#ifdef WINDOWS
+    std::vector<char> buffer;
+#endif
+};
+
+
+ALWAYS_INLINE bool is_blank(char c)
+{
+    //! CHARACTERS THAT ARE IGNORED AROUND A TOKEN
+    return c==' ' || c=='\t' || c=='\r';
+}
+
+ALWAYS_INLINE bool is_separator(char c, char delim)
+{
+    //! CHARACTERS THAT TERMINATE A TOKEN
+    return c==delim || c==' ' || c=='\t' || c=='\r' || c=='\n';
+}
+
+ALWAYS_INLINE bool is_content(char c, char delim)
+{
+    //! CHARACTERS THAT MAKE A LINE A ROW. LINES OF ONLY DELIMITERS AND
+    //! WHITE SPACE ARE SKIPPED
+    return c!=delim && c!='\n' && !is_blank(c);
+}
+
+ALWAYS_INLINE const char* skip_blanks(const char *p, const char *end, char delim)
+{
+    //! SKIP DELIMITERS AND WHITE SPACE BUT STOP AT A NEW LINE
+    while (p<end && *p!='\n' && (*p==delim || is_blank(*p))) ++p;
+    return p;
+}
+
+ALWAYS_INLINE const char* token_end(const char *p, const char *end, char delim)
+{
+    while (p<end && !is_separator(*p,delim)) ++p;
+    return p;
+}
+
+
+inline Real parse_real_slow(const char *first, const char *last)
+{
+    //! FALL BACK TO THE C LIBRARY FOR TOKENS OUTSIDE THE EXACT FAST PATH.
+    //! THE TOKEN IS COPIED AS THE MAPPED FILE IS NOT NULL-TERMINATED
+    char buf[64];
+    const size_t n = static_cast<size_t>(last-first);
+    if (n < sizeof(buf))
+    {
+        std::memcpy(buf,first,n);
+        buf[n] = '\0';
+        return std::strtod(buf,nullptr);
+    }
+    return std::strtod(std::string(first,last).c_str(),nullptr);
+}
+
+inline const char* parse_real(const char *first, const char *last, char delim, Real &value)
+{
+    //! FROM_CHARS-LIKE FLOATING POINT PARSER. THE DECIMAL SIGNIFICAND IS
+    //! ACCUMULATED IN A 64-BIT INTEGER WITH TRAILING ZEROS DEFERRED, SO
+    //! PADDED OUTPUT SUCH AS 3.600000000000000000e+01 STAYS EXACT. WHEN
+    //! THE SIGNIFICAND FITS IN 53 BITS AND THE POWER OF TEN IN [-22,22]
+    //! A SINGLE MULTIPLICATION/DIVISION IS CORRECTLY ROUNDED (CLINGER'S
+    //! FAST PATH). EVERYTHING ELSE IS DELEGATED TO STRTOD. RETURNS THE
+    //! POSITION PAST THE TOKEN
+
+    static const Real powers_of_ten[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    static const std::uint64_t integer_powers_of_ten[] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+        100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL,
+        10000000000000ULL, 100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+        100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL};
+
+    const char *p = first;
+    bool negative = false;
+    if (p<last && (*p=='-' || *p=='+')) {
+        negative = *p=='-';
+        ++p;
+    }
+
+    std::uint64_t mantissa = 0;
+    Integer exponent = 0;
+    Integer pending_zeros = 0, pending_fractional = 0;
+    Integer significant_digits = 0;
+    bool fractional = false, any_digit = false, exact = true;
+
+    for (; p<last; ++p)
+    {
+        const char c = *p;
+        if (c>='0' && c<='9')
+        {
+            any_digit = true;
+            if (c=='0')
+            {
+                ++pending_zeros;
+                pending_fractional += fractional;
+                continue;
+            }
+            // COMMIT THE DEFERRED ZEROS TOGETHER WITH THIS DIGIT
+            const Integer shift = pending_zeros+1;
+            significant_digits = mantissa==0 ? 1 : significant_digits+shift;
+            if (significant_digits > 19) {
+                exact = false;
+                break;
+            }
+            mantissa = mantissa==0 ? static_cast<std::uint64_t>(c-'0') :
+                mantissa*integer_powers_of_ten[shift] + static_cast<std::uint64_t>(c-'0');
+            exponent -= pending_fractional + fractional;
+            pending_zeros = pending_fractional = 0;
+        }
+        else if (c=='.' && !fractional)
+        {
+            fractional = true;
+        }
+        else
+        {
+            break;
+        }
+    }
+    // TRAILING ZEROS OF THE INTEGRAL PART SCALE THE VALUE, FRACTIONAL ONES DO NOT
+    exponent += pending_zeros - pending_fractional;
+
+    if (exact && any_digit && p<last && (*p=='e' || *p=='E'))
+    {
+        const char *q = p+1;
+        bool negative_exponent = false;
+        if (q<last && (*q=='-' || *q=='+')) {
+            negative_exponent = *q=='-';
+            ++q;
+        }
+        if (q<last && *q>='0' && *q<='9')
+        {
+            Integer e = 0;
+            for (; q<last && *q>='0' && *q<='9'; ++q)
+                if (e < 100000) e = 10*e + (*q-'0');
+            exponent += negative_exponent ? -e : e;
+            p = q;
+        }
+    }
+
+    if (!exact || !any_digit || (p<last && !is_separator(*p,delim)))
+    {
+        // INF/NAN, TOO MANY DIGITS OR TRAILING GARBAGE
+        const char *stop = token_end(p,last,delim);
+        value = parse_real_slow(first,stop);
+        return stop;
+    }
+
+    if (mantissa==0) {
+        value = negative ? -0.0 : 0.0;
+        return p;
+    }
+
+    if (mantissa <= (std::uint64_t(1) << 53) && exponent >= -22 && exponent <= 22)
+    {
+        Real v = static_cast<Real>(mantissa);
+        v = exponent < 0 ? v/powers_of_ten[-exponent] : v*powers_of_ten[exponent];
+        value = negative ? -v : v;
+        return p;
+    }
+
+    value = parse_real_slow(first,p);
+    return p;
+}
+
+template<typename T>
+inline const char* parse_integer(const char *first, const char *last, char delim, T &value)
+{
+    //! FROM_CHARS-LIKE INTEGER PARSER. INTEGER ARRAYS WRITTEN BY NUMPY.SAVETXT
+    //! COME IN FLOATING POINT NOTATION (E.G. 3.600000000000000000e+01),
+    //! IN WHICH CASE THE TOKEN IS RE-PARSED AS REAL AND ROUNDED. VALUES THAT
+    //! DO NOT FIT IN T THROW std::out_of_range
+    const std::uint64_t max_positive = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+    const std::uint64_t max_negative = std::numeric_limits<T>::is_signed ? max_positive+1 : 0;
+
+    const char *p = first;
+    bool negative = false;
+    if (p<last && (*p=='-' || *p=='+')) {
+        negative = *p=='-';
+        ++p;
+    }
+    const char *digits = p;
+    std::uint64_t v = 0;
+    bool overflow = false;
+    for (; p<last && *p>='0' && *p<='9'; ++p)
+    {
+        const std::uint64_t digit = static_cast<std::uint64_t>(*p-'0');
+        overflow |= v > (std::numeric_limits<std::uint64_t>::max()-digit)/10;
+        v = 10*v + digit;
+    }
+
+    if (p==digits || (p<last && !is_separator(*p,delim)))
+    {
+        Real r;
+        p = parse_real(first,last,delim,r);
+        // THE ROUNDED VALUE MUST LIE IN [min,max] OF T
+        const Real bound = std::ldexp(Real(1),std::numeric_limits<T>::digits);
+        const Real lower = std::numeric_limits<T>::is_signed ? -bound-0.5 : -0.5;
+        if (!(r > lower && r < bound-0.5)) {
+            throw std::out_of_range("Integer value "+std::string(first,p)+" is out of range");
+        }
+        const Real rounded = std::round(r);
+        value = rounded < 0 ? static_cast<T>(static_cast<Integer>(rounded)) :
+            static_cast<T>(static_cast<std::uint64_t>(rounded));
+        return p;
+    }
+    if (overflow || (negative ? v > max_negative : v > max_positive)) {
+        throw std::out_of_range("Integer value "+std::string(first,p)+" is out of range");
+    }
+    value = negative ? static_cast<T>(std::uint64_t(0)-v) : static_cast<T>(v);
+    return p;
+}
+
+template<typename T>
+ALWAYS_INLINE const char* parse_value(const char *first, const char *last, char delim, T &value)
+{
+    return parse_integer(first,last,delim,value);
+}
+
+template<>
+ALWAYS_INLINE const char* parse_value<Real>(const char *first, const char *last, char delim, Real &value)
+{
+    return parse_real(first,last,delim,value);
+}
+
+
+inline Integer count_columns(const char *p, const char *end, char delim)
+{
+    //! NUMBER OF TOKENS ON THE FIRST NON-EMPTY LINE
+    Integer cols = 0;
+    while (p<end)
+    {
+        p = skip_blanks(p,end,delim);
+        if (p==end) break;
+        if (*p=='\n') {
+            if (cols>0) break;
+            ++p;
+            continue;
+        }
+        ++cols;
+        p = token_end(p,end,delim);
+    }
+    return cols;
+}
+
+inline Integer count_rows(const char *p, const char *end, char delim)
+{
+    //! NUMBER OF LINES THAT CONTAIN AT LEAST ONE TOKEN. AGREES WITH
+    //! fill_rows, WHICH PARSES EXACTLY THESE LINES
+    Integer rows = 0;
+    bool has_content = false;
+    for (; p<end; ++p)
+    {
+        const char c = *p;
+        if (c=='\n') {
+            rows += has_content;
+            has_content = false;
+        }
+        else if (is_content(c,delim)) {
+            has_content = true;
+        }
+    }
+    return rows + has_content;
+}
+
+inline Integer count_tokens(const char *p, const char *end, char delim)
+{
+    //! TOTAL NUMBER OF TOKENS IN THE RANGE
+    Integer tokens = 0;
+    while (p<end)
+    {
+        if (is_separator(*p,delim)) {
+            ++p;
+            continue;
+        }
+        ++tokens;
+        p = token_end(p,end,delim);
+    }
+    return tokens;
+}
+
+template<typename T>
+inline Integer fill_rows(const char *p, const char *end, char delim, T *out, Integer rows, Integer cols)
+{
+    //! PARSE EVERY NON-EMPTY LINE IN [p,end) AS A ROW OF EXACTLY cols VALUES
+    //! AND WRITE IT CONTIGUOUSLY (ROW-MAJOR) TO out, WHICH HOLDS rows ROWS.
+    //! RETURNS THE NUMBER OF ROWS WRITTEN
+    Integer row = 0;
+    while (p<end)
+    {
+        p = skip_blanks(p,end,delim);
+        if (p==end) break;
+        if (*p=='\n') {
+            ++p;
+            continue;
+        }
+        if (row==rows) {
+            throw std::runtime_error("More rows than counted");
+        }
+
+        T *row_ptr = out + row*cols;
+        Integer j = 0;
+        while (p<end && *p!='\n')
+        {
+            if (j==cols) {
+                throw std::invalid_argument("Inconsistent number of columns in row "+std::to_string(row));
+            }
+            p = parse_value(p,end,delim,row_ptr[j]);
+            ++j;
+            p = skip_blanks(p,end,delim);
+        }
+        if (j!=cols) {
+            throw std::invalid_argument("Inconsistent number of columns in row "+std::to_string(row));
+        }
+        ++row;
+    }
+    return row;
+}
+
+template<typename T>
+inline Integer fill_tokens(const char *p, const char *end, char delim, T *out)
+{
+    //! PARSE EVERY TOKEN IN [p,end) REGARDLESS OF LINE BREAKS
+    Integer counter = 0;
+    while (p<end)
+    {
+        if (is_separator(*p,delim)) {
+            ++p;
+            continue;
+        }
+        p = parse_value(p,end,delim,out[counter]);
+        ++counter;
+    }
+    return counter;
+}
+
+
+inline std::vector<const char*> split_lines(const char *begin, const char *end, Integer nchunks)
+{
+    //! SPLIT [begin,end) INTO AT MOST nchunks PIECES OF ROUGHLY EQUAL SIZE
+    //! WHOSE BOUNDARIES FALL JUST AFTER A NEW LINE. RETURNS THE nchunks+1
+    //! BOUNDARIES, EMPTY CHUNKS ARE POSSIBLE FOR FILES WITH VERY LONG LINES
+    const size_t nbytes = static_cast<size_t>(end-begin);
+    std::vector<const char*> bounds(nchunks+1);
+    bounds[0] = begin;
+    bounds[nchunks] = end;
+    for (Integer k=1; k<nchunks; ++k)
+    {
+        const char *p = std::max(begin + nbytes*k/nchunks, bounds[k-1]);
+        const char *newline = static_cast<const char*>(std::memchr(p,'\n',end-p));
+        bounds[k] = newline ? newline+1 : end;
+    }
+    return bounds;
+}
+
+// FILES SMALLER THAN THIS ARE PARSED ON A SINGLE THREAD
+#define POSTMESH_PARALLEL_IO_THRESHOLD (size_t(1) << 22)
+
+template<typename T>
+inline Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>
+ReadMatrix(const std::string &filename, char delim)
+{
+    //! READ A DELIMITED 2D ARRAY INTO A ROW-MAJOR EIGEN MATRIX. THE MAPPED
+    //! FILE IS SPLIT INTO NEW LINE ALIGNED CHUNKS, THE ROWS OF EVERY CHUNK
+    //! ARE COUNTED CONCURRENTLY, THEIR PREFIX SUM GIVES THE FIRST OUTPUT ROW
+    //! OF EACH CHUNK AND THE CHUNKS ARE THEN PARSED CONCURRENTLY IN PLACE
+    typedef Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixType;
+
+    MappedFile file(filename);
+    if (!file.IsOpen())
+    {
+        warn("Unable to read file", filename);
+        return MatrixType();
+    }
+
+    const Integer cols = count_columns(file.begin(),file.end(),delim);
+    if (cols==0) return MatrixType();
+
+    const Integer nchunks = file.size() < POSTMESH_PARALLEL_IO_THRESHOLD ? 1 : GetNumberOfThreads();
+    const std::vector<const char*> bounds = split_lines(file.begin(),file.end(),nchunks);
+
+    std::vector<Integer> offsets(nchunks+1,0);
+    parallel_for(0,nchunks,[&](Integer lo, Integer hi) {
+        for (Integer k=lo; k<hi; ++k)
+            offsets[k+1] = count_rows(bounds[k],bounds[k+1],delim);
+    });
+    std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
+
+    MatrixType out_arr(offsets[nchunks],cols);
+    T *data = out_arr.data();
+    parallel_for(0,nchunks,[&](Integer lo, Integer hi) {
+        for (Integer k=lo; k<hi; ++k)
+        {
+            const Integer rows = offsets[k+1]-offsets[k];
+            Integer rows_written = 0;
+            try {
+                rows_written = fill_rows(bounds[k],bounds[k+1],delim,data+offsets[k]*cols,rows,cols);
+            }
+            catch (std::invalid_argument &) {
+                throw std::invalid_argument("Inconsistent number of columns in "+filename);
+            }
+            catch (std::runtime_error &) {
+                throw std::runtime_error("Could not parse every row of "+filename);
+            }
+            if (rows_written != rows) {
+                throw std::runtime_error("Could not parse every row of "+filename);
+            }
+        }
+    });
+
+    return out_arr;
+}
+
+template<typename T>
+inline Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>
+ReadTokens(const std::string &filename, char delim)
+{
+    //! READ EVERY TOKEN OF A FILE INTO A COLUMN VECTOR, CHUNKED AND
+    //! PARSED CONCURRENTLY IN THE SAME WAY AS ReadMatrix
+    typedef Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> MatrixType;
+
+    MappedFile file(filename);
+    if (!file.IsOpen())
+    {
+        warn("Unable to read file", filename);
+        return MatrixType();
+    }
+
+    const Integer nchunks = file.size() < POSTMESH_PARALLEL_IO_THRESHOLD ? 1 : GetNumberOfThreads();
+    const std::vector<const char*> bounds = split_lines(file.begin(),file.end(),nchunks);
+
+    std::vector<Integer> offsets(nchunks+1,0);
+    parallel_for(0,nchunks,[&](Integer lo, Integer hi) {
+        for (Integer k=lo; k<hi; ++k)
+            offsets[k+1] = count_tokens(bounds[k],bounds[k+1],delim);
+    });
+    std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
+
+    MatrixType out_arr(offsets[nchunks],1);
+    T *data = out_arr.data();
+    parallel_for(0,nchunks,[&](Integer lo, Integer hi) {
+        for (Integer k=lo; k<hi; ++k)
+            if (fill_tokens(bounds[k],bounds[k+1],delim,data+offsets[k]) != offsets[k+1]-offsets[k]) {
+                throw std::runtime_error("Could not parse every token of "+filename);
+            }
+    });
+
+    return out_arr;
+}
+
+
+
+
+// BINARY MESH CONTAINER
+// ---------------------
+// A FILE STARTS WITH A 64-BYTE BinaryHeader FOLLOWED BY A TABLE OF
+// ArrayRecords. EVERY ARRAY IS STORED ROW-MAJOR AT A 64-BYTE ALIGNED
+// OFFSET, SO A MAPPED FILE CAN BE VIEWED AS EIGEN MATRICES IN PLACE.
+// ALL FIELDS ARE WRITTEN IN THE NATIVE BYTE ORDER OF THE PRODUCER AND
+// THE endianness FIELD RECORDS WHICH ONE THAT WAS
+
+#define POSTMESH_BINARY_MAGIC "PMSHBIN"
+#define POSTMESH_BINARY_VERSION 1
+#define POSTMESH_BINARY_ENDIANNESS 0x01020304u
+#define POSTMESH_BINARY_ALIGNMENT 64
+
+enum DType : std::uint32_t
+{
+    DTYPE_INT32 = 1,
+    DTYPE_UINT32 = 2,
+    DTYPE_INT64 = 3,
+    DTYPE_UINT64 = 4,
+    DTYPE_FLOAT64 = 5
+};
+
+ALWAYS_INLINE std::uint32_t dtype_itemsize(std::uint32_t dtype)
+{
+    //! SIZE IN BYTES OF AN ITEM OF A DTYPE, 0 FOR UNKNOWN TYPES
+    switch (dtype)
+    {
+        case DTYPE_INT32: case DTYPE_UINT32: return 4;
+        case DTYPE_INT64: case DTYPE_UINT64: case DTYPE_FLOAT64: return 8;
+        default: return 0;
+    }
+}
+
+template<typename T> struct dtype_of;
+template<> struct dtype_of<std::int32_t> {static const std::uint32_t value = DTYPE_INT32;};
+template<> struct dtype_of<std::uint32_t> {static const std::uint32_t value = DTYPE_UINT32;};
+template<> struct dtype_of<long long> {static const std::uint32_t value = DTYPE_INT64;};
+template<> struct dtype_of<unsigned long long> {static const std::uint32_t value = DTYPE_UINT64;};
+template<> struct dtype_of<double> {static const std::uint32_t value = DTYPE_FLOAT64;};
+
+struct BinaryHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t endianness;
+    std::uint64_t narrays;
+    std::uint64_t table_offset;
+    std::uint64_t reserved[4];
+};
+
+struct ArrayRecord
+{
+    char name[32];
+    std::uint32_t dtype;
+    std::uint32_t itemsize;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t offset;
+    std::uint64_t nbytes;
+    std::uint64_t checksum;
+};
+
+static_assert(sizeof(BinaryHeader)==64, "Unexpected padding in BinaryHeader");
+static_assert(sizeof(ArrayRecord)==80, "Unexpected padding in ArrayRecord");
+
+inline std::uint64_t checksum(const void *data, size_t nbytes)
+{
+    //! 64-BIT FNV-1a HASH, CONSUMING EIGHT BYTES PER ROUND
+    const std::uint64_t prime = 1099511628211ULL;
+    std::uint64_t hash = 14695981039346656037ULL;
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    const size_t nwords = nbytes/8;
+    for (size_t i=0; i<nwords; ++i)
+    {
+        std::uint64_t word;
+        std::memcpy(&word,p+8*i,8);
+        hash = (hash ^ word)*prime;
+    }
+    for (size_t i=8*nwords; i<nbytes; ++i)
+        hash = (hash ^ p[i])*prime;
+    return hash;
+}
+
+struct ArrayDescriptor
+{
+    //! AN ARRAY TO BE WRITTEN TO A BINARY CONTAINER
+    std::string name;
+    std::uint32_t dtype;
+    std::uint32_t itemsize;
+    std::uint64_t rows;
+    std::uint64_t cols;
+    const void *data;
+};
+
+template<typename Derived>
+ALWAYS_INLINE ArrayDescriptor MakeArrayDescriptor(const std::string &name, const Eigen::DenseBase<Derived> &arr)
+{
+    //! DESCRIBE A ROW-MAJOR EIGEN MATRIX (OR MAP) FOR WriteBinary
+    typedef typename Derived::Scalar T;
+    static_assert(Derived::IsRowMajor || Derived::ColsAtCompileTime==1,
+        "Binary containers store row-major arrays");
+    ArrayDescriptor desc;
+    desc.name = name;
+    desc.dtype = dtype_of<T>::value;
+    desc.itemsize = sizeof(T);
+    desc.rows = arr.rows();
+    desc.cols = arr.cols();
+    desc.data = arr.derived().data();
+    return desc;
+}
+
+inline void WriteBinary(const std::string &filename, const std::vector<ArrayDescriptor> &arrays)
+{
+    //! WRITE A SET OF ARRAYS TO A VERSIONED BINARY CONTAINER
+    BinaryHeader header;
+    std::memset(&header,0,sizeof(header));
+    std::memcpy(header.magic,POSTMESH_BINARY_MAGIC,sizeof(POSTMESH_BINARY_MAGIC));
+    header.version = POSTMESH_BINARY_VERSION;
+    header.endianness = POSTMESH_BINARY_ENDIANNESS;
+    header.narrays = arrays.size();
+    header.table_offset = sizeof(BinaryHeader);
+
+    std::vector<ArrayRecord> table(arrays.size());
+    std::uint64_t offset = sizeof(BinaryHeader) + arrays.size()*sizeof(ArrayRecord);
+    for (size_t i=0; i<arrays.size(); ++i)
+    {
+        const ArrayDescriptor &desc = arrays[i];
+        if (desc.name.size() >= sizeof(table[i].name))
+            throw std::invalid_argument("Array name too long for binary container: "+desc.name);
+
+        ArrayRecord &record = table[i];
+        std::memset(&record,0,sizeof(record));
+        std::memcpy(record.name,desc.name.c_str(),desc.name.size());
+        record.dtype = desc.dtype;
+        record.itemsize = desc.itemsize;
+        record.rows = desc.rows;
+        record.cols = desc.cols;
+        record.nbytes = desc.rows*desc.cols*desc.itemsize;
+        offset = (offset + POSTMESH_BINARY_ALIGNMENT - 1)/POSTMESH_BINARY_ALIGNMENT*POSTMESH_BINARY_ALIGNMENT;
+        record.offset = offset;
+        record.checksum = checksum(desc.data,record.nbytes);
+        offset += record.nbytes;
+    }
+
+    std::ofstream datafile(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (!datafile)
+        throw std::runtime_error("Unable to write file "+filename);
+
+    datafile.write(reinterpret_cast<const char*>(&header),sizeof(header));
+    datafile.write(reinterpret_cast<const char*>(table.data()),table.size()*sizeof(ArrayRecord));
+    std::uint64_t position = sizeof(BinaryHeader) + table.size()*sizeof(ArrayRecord);
+    const char padding[POSTMESH_BINARY_ALIGNMENT] = {};
+    for (size_t i=0; i<arrays.size(); ++i)
+    {
+        datafile.write(padding,table[i].offset-position);
+        datafile.write(static_cast<const char*>(arrays[i].data),table[i].nbytes);
+        position = table[i].offset + table[i].nbytes;
+    }
+
+    if (!datafile)
+        throw std::runtime_error("Failed writing binary container "+filename);
+}
+
+class BinaryFile
+{
+public:
+    //! READER FOR BINARY CONTAINERS. THE FILE IS MAPPED PRIVATELY AND ITS
+    //! ARRAYS ARE HANDED OUT AS EIGEN MAPS INTO THE MAPPING, WITHOUT ANY
+    //! COPY OR PARSE STEP. THE MAPS ARE VALID FOR THE LIFETIME OF THE OBJECT
+
+    ALWAYS_INLINE BinaryFile() : header(nullptr), table(nullptr) {}
+
+    ALWAYS_INLINE explicit BinaryFile(const std::string &filename) : header(nullptr), table(nullptr)
+    {
+        this->Open(filename);
+    }
+
+    inline void Open(const std::string &filename)
+    {
+        if (!this->file.Open(filename,true))
+            throw std::runtime_error("Unable to read file "+filename);
+
+        const size_t nbytes = this->file.size();
+        if (nbytes < sizeof(BinaryHeader) ||
+            std::memcmp(this->file.begin(),POSTMESH_BINARY_MAGIC,sizeof(POSTMESH_BINARY_MAGIC))!=0)
+            throw std::runtime_error(filename+" is not a PostMesh binary container");
+
+        this->header = reinterpret_cast<const BinaryHeader*>(this->file.begin());
+        if (this->header->endianness != POSTMESH_BINARY_ENDIANNESS)
+            throw std::runtime_error(filename+" was written on a machine with different byte order");
+        if (this->header->version > POSTMESH_BINARY_VERSION)
+            throw std::runtime_error(filename+" was written by a newer version of PostMesh");
+        // THE COMPARISONS ARE ARRANGED SO THAT NO SUM OR PRODUCT OF UNTRUSTED
+        // FIELDS CAN OVERFLOW
+        if (this->header->table_offset > nbytes ||
+            this->header->narrays > (nbytes - this->header->table_offset)/sizeof(ArrayRecord))
+            throw std::runtime_error(filename+" is truncated");
+        if (this->header->table_offset % alignof(ArrayRecord) != 0)
+            throw std::runtime_error(filename+" has a misaligned array table");
+
+        this->table = reinterpret_cast<const ArrayRecord*>(this->file.begin() + this->header->table_offset);
+        for (std::uint64_t i=0; i<this->header->narrays; ++i)
+        {
+            const ArrayRecord &record = this->table[i];
+            const std::uint32_t itemsize = dtype_itemsize(record.dtype);
+            if (itemsize == 0 || record.itemsize != itemsize || !this->Fits(record,itemsize))
+                throw std::runtime_error(filename+" is corrupt or truncated");
+        }
+    }
+
+    ALWAYS_INLINE Integer NbArrays() const
+    {
+        return this->header ? static_cast<Integer>(this->header->narrays) : 0;
+    }
+
+    ALWAYS_INLINE const ArrayRecord& Record(Integer i) const
+    {
+        return this->table[i];
+    }
+
+    inline const ArrayRecord* Find(const std::string &name) const
+    {
+        for (Integer i=0; i<this->NbArrays(); ++i)
+        {
+            if (std::strncmp(this->table[i].name,name.c_str(),sizeof(this->table[i].name))==0)
+                return this->table+i;
+        }
+        return nullptr;
+    }
+
+    ALWAYS_INLINE bool Contains(const void *data) const
+    {
+        //! WHETHER data POINTS INTO THE MAPPING
+        const char *p = static_cast<const char*>(data);
+        return std::less_equal<const char*>()(this->file.begin(),p) && std::less<const char*>()(p,this->file.end());
+    }
+
+    ALWAYS_INLINE bool Verify(const ArrayRecord &record) const
+    {
+        return checksum(this->file.begin()+record.offset,record.nbytes)==record.checksum;
+    }
+
+    ALWAYS_INLINE ArrayDescriptor Describe(const ArrayRecord &record) const
+    {
+        //! DESCRIBE A MAPPED ARRAY, E.G. TO WRITE IT TO ANOTHER CONTAINER
+        ArrayDescriptor desc;
+        desc.name = std::string(record.name,std::find(record.name,record.name+sizeof(record.name),'\0'));
+        desc.dtype = record.dtype;
+        desc.itemsize = record.itemsize;
+        desc.rows = record.rows;
+        desc.cols = record.cols;
+        desc.data = this->file.begin()+record.offset;
+        return desc;
+    }
+
+    template<typename T>
+    ALWAYS_INLINE Eigen::Map<Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>> View(const ArrayRecord &record)
+    {
+        //! THE RECORD IS CHECKED AGAIN AGAINST T, SO THAT THE MAP NEVER READS
+        //! PAST THE MAPPING OR THROUGH A MISALIGNED POINTER
+        if (record.dtype != dtype_of<T>::value || record.itemsize != sizeof(T) ||
+            record.offset % alignof(T) != 0 || !this->Fits(record,sizeof(T)))
+            throw std::runtime_error(std::string("Unexpected data type for array ")+
+                std::string(record.name,std::find(record.name,record.name+sizeof(record.name),'\0')));
+        return Eigen::Map<Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED>>(
+            reinterpret_cast<T*>(this->file.data()+record.offset),record.rows,record.cols);
+    }
+
+    template<typename T>
+    inline Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> Convert(const ArrayRecord &record)
+    {
+        //! COPY AN INTEGER ARRAY OF ANY STORED WIDTH INTO AN ARRAY OF TYPE T,
+        //! E.G. 64-BIT CONNECTIVITY INTO A POSTMESH_INDEX32 BUILD. VALUES THAT
+        //! DO NOT FIT INTO T ARE AN ERROR
+        switch (record.dtype)
+        {
+            case DTYPE_INT32: return this->ConvertFrom<std::int32_t,T>(record);
+            case DTYPE_UINT32: return this->ConvertFrom<std::uint32_t,T>(record);
+            case DTYPE_INT64: return this->ConvertFrom<long long,T>(record);
+            case DTYPE_UINT64: return this->ConvertFrom<unsigned long long,T>(record);
+            default: throw std::runtime_error(std::string("Unexpected data type for array ")+record.name);
+        }
+    }
+
+private:
+    ALWAYS_INLINE bool Fits(const ArrayRecord &record, std::uint64_t itemsize) const
+    {
+        //! rows*cols*itemsize == nbytes WITHOUT OVERFLOW, THE SHAPE FITS AN
+        //! EIGEN INDEX, THE DATA IS ALIGNED TO ITS ITEMS AND LIES IN THE FILE
+        const std::uint64_t max_index = static_cast<std::uint64_t>(std::numeric_limits<std::ptrdiff_t>::max());
+        const std::uint64_t size = this->file.size();
+        if (record.rows > max_index || record.cols > max_index)
+            return false;
+        if (record.cols != 0 && record.rows > std::numeric_limits<std::uint64_t>::max()/record.cols)
+            return false;
+        const std::uint64_t nitems = record.rows*record.cols;
+        if (nitems > std::numeric_limits<std::uint64_t>::max()/itemsize || nitems*itemsize != record.nbytes)
+            return false;
+        return record.offset % itemsize == 0 && record.offset <= size && record.nbytes <= size - record.offset;
+    }
+
+    template<typename U, typename T>
+    inline Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> ConvertFrom(const ArrayRecord &record)
+    {
+        auto from = this->View<U>(record);
+        Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> arr(from.rows(),from.cols());
+        for (Integer i=0; i<from.size(); ++i)
+        {
+            const U value = from.data()[i];
+            const T converted = static_cast<T>(value);
+            if (static_cast<U>(converted) != value || std::less<U>()(value,U(0)) != std::less<T>()(converted,T(0)))
+                throw std::overflow_error(std::string("Values of array ")+record.name+" do not fit the index type of this build");
+            arr.data()[i] = converted;
+        }
+        return arr;
+    }
+
+    MappedFile file;
+    const BinaryHeader *header;
+    const ArrayRecord *table;
+};
+
+inline bool ValidOffsets(const UInteger *offsets, Integer n, UInteger total)
+{
+    //! CHECK THAT n OFFSETS READ FROM A FILE START AT ZERO, NEVER DECREASE
+    //! AND STAY WITHIN total, SO THEY CAN SAFELY DELIMIT RANGES OF AN ARRAY
+    if (n == 0 || offsets[0] != 0)
+        return false;
+    for (Integer i=1; i<n; ++i)
+    {
+        if (offsets[i] < offsets[i-1])
+            return false;
+    }
+    return offsets[n-1] <= total;
+}
+
+inline std::string FileKey(const std::string &filename)
+{
+    //! KEY IDENTIFYING THE CONTENTS OF A FILE: THE HEX 64-BIT FNV-1a HASH
+    //! OF THE CONTENTS FOLLOWED BY THE SIZE OF THE FILE
+    MappedFile file;
+    if (!file.Open(filename))
+        throw std::runtime_error("Unable to read file "+filename);
+    std::ostringstream key;
+    key << std::hex;
+    key.fill('0');
+    key.width(16);
+    key << checksum(file.begin(),file.size());
+    key << "-" << std::dec << file.size();
+    return key.str();
+}
+
+inline std::string TemporaryName(const std::string &filename)
+{
+    //! NAME OF A TEMPORARY FILE NEXT TO filename THAT NO OTHER PROCESS OR
+    //! THREAD USES AT THE SAME TIME, TO BE RENAMED TO filename ONCE WRITTEN
+    static std::atomic<UInteger> counter(0);
+    std::ostringstream name;
+    name << filename << "." << getpid() << "." << counter++ << ".tmp";
+    return name.str();
+}
+
+
+
+
+// STREAMING VTU WRITER
+// --------------------
+// WRITES AN UNSTRUCTURED GRID AS A VTK XML FILE WITH RAW APPENDED DATA.
+// ALL ARRAYS ARE DECLARED UP FRONT, WHICH FIXES THEIR OFFSETS IN THE
+// APPENDED SECTION, AND ARE THEN STREAMED ONE AFTER THE OTHER IN THE
+// ORDER OF DECLARATION, SO THE CALLER NEVER HOLDS MORE THAN A CHUNK
+
+#define POSTMESH_VTU_CHUNK 65536
+
+template<typename T> struct vtu_type_of;
+template<> struct vtu_type_of<std::uint8_t> {static const char *name() {return "UInt8";}};
+template<> struct vtu_type_of<long long> {static const char *name() {return "Int64";}};
+template<> struct vtu_type_of<double> {static const char *name() {return "Float64";}};
+
+class VTUStream
+{
+public:
+    VTUStream(const std::string &filename, Integer npoints, Integer ncells) :
+        filename(filename), npoints(npoints), ncells(ncells), current(-1), remaining(0) {}
+
+    template<typename T>
+    void DeclareArray(const std::string &section, const std::string &name, Integer ncomponents, Integer nvalues)
+    {
+        //! section IS ONE OF Points, Cells, PointData OR CellData. ARRAYS OF
+        //! THE SAME SECTION MUST BE DECLARED CONSECUTIVELY
+        VTUArray arr = {section,name,vtu_type_of<T>::name(),ncomponents,
+                        static_cast<std::uint64_t>(nvalues)*sizeof(T)};
+        this->arrays.push_back(arr);
+    }
+
+    void WriteHeader()
+    {
+        this->datafile.open(this->filename.c_str(), std::ios::binary | std::ios::trunc);
+        if (!this->datafile)
+            throw std::runtime_error("Unable to write file "+this->filename);
+
+        const std::uint16_t probe = 1;
+        const bool little_endian = *reinterpret_cast<const std::uint8_t*>(&probe) == 1;
+
+        std::ostringstream xml;
+        xml << "<?xml version=\"1.0\"?>\n"
+            << "<VTKFile type=\"UnstructuredGrid\" version=\"2.2\" byte_order=\""
+            << (little_endian ? "LittleEndian" : "BigEndian") << "\" header_type=\"UInt64\">\n"
+            << "  <UnstructuredGrid>\n"
+            << "    <Piece NumberOfPoints=\"" << this->npoints << "\" NumberOfCells=\"" << this->ncells << "\">\n";
+
+        std::uint64_t offset = 0;
+        for (size_t i=0; i<this->arrays.size(); ++i)
+        {
+            const VTUArray &arr = this->arrays[i];
+            if (i==0 || arr.section != this->arrays[i-1].section)
+                xml << "      <" << arr.section << ">\n";
+            xml << "        <DataArray type=\"" << arr.type << "\"";
+            if (!arr.name.empty()) xml << " Name=\"" << arr.name << "\"";
+            xml << " NumberOfComponents=\"" << arr.ncomponents << "\" format=\"appended\" offset=\"" << offset << "\"/>\n";
+            if (i+1==this->arrays.size() || arr.section != this->arrays[i+1].section)
+                xml << "      </" << arr.section << ">\n";
+            offset += sizeof(std::uint64_t) + arr.nbytes;
+        }
+
+        xml << "    </Piece>\n"
+            << "  </UnstructuredGrid>\n"
+            << "  <AppendedData encoding=\"raw\">\n"
+            << "   _";
+        const std::string header = xml.str();
+        this->datafile.write(header.data(),header.size());
+    }
+
+    template<typename T>
+    void Write(const T *data, Integer nvalues)
+    {
+        //! STREAM THE NEXT CHUNK OF THE CURRENT ARRAY. THE BLOCK HEADER OF AN
+        //! ARRAY IS EMITTED WHEN ITS FIRST CHUNK ARRIVES, EMPTY ARRAYS ARE
+        //! PASSED OVER
+        if (nvalues == 0) return;
+        while (this->remaining == 0)
+            this->BeginNextArray();
+        const std::uint64_t nbytes = static_cast<std::uint64_t>(nvalues)*sizeof(T);
+        if (nbytes > this->remaining)
+            throw std::logic_error("Too much data streamed for VTU array "+this->arrays[this->current].name);
+        this->datafile.write(reinterpret_cast<const char*>(data),nbytes);
+        this->remaining -= nbytes;
+    }
+
+    void Close()
+    {
+        while (this->current+1 < static_cast<Integer>(this->arrays.size()) || this->remaining != 0)
+        {
+            if (this->remaining != 0)
+                throw std::logic_error("Too little data streamed for VTU array "+this->arrays[this->current].name);
+            this->BeginNextArray();
+        }
+        const char footer[] = "\n  </AppendedData>\n</VTKFile>\n";
+        this->datafile.write(footer,sizeof(footer)-1);
+        this->datafile.close();
+        if (!this->datafile)
+            throw std::runtime_error("Failed writing VTU file "+this->filename);
+    }
+
+private:
+    struct VTUArray
+    {
+        std::string section;
+        std::string name;
+        const char *type;
+        Integer ncomponents;
+        std::uint64_t nbytes;
+    };
+
+    void BeginNextArray()
+    {
+        ++this->current;
+        if (this->current >= static_cast<Integer>(this->arrays.size()))
+            throw std::logic_error("More VTU arrays streamed than declared");
+        this->remaining = this->arrays[this->current].nbytes;
+        this->datafile.write(reinterpret_cast<const char*>(&this->remaining),sizeof(std::uint64_t));
+    }
+
+    std::string filename;
+    Integer npoints;
+    Integer ncells;
+    std::vector<VTUArray> arrays;
+    std::ofstream datafile;
+    Integer current;
+    std::uint64_t remaining;
+};
+
+}
+// end of namespace
+
+// SHORTEN THE NAMESPACE
+namespace pio = postmesh_io;
+
+#endif // IO_FUNCS_HPP
@@ -0,0 +1,365 @@
+#ifndef NODE_ARRANGEMENT_HPP
+#define NODE_ARRANGEMENT_HPP
+
+#ifndef EIGEN_INC_HPP
+#include <EIGEN_INC.hpp>
+#endif
+
+#include <array>
+#include <map>
+
+
+// NODE ARRANGEMENTS OF HIGH ORDER LAGRANGE ELEMENTS. EVERY NODE OF AN
+// ELEMENT OF DEGREE p IS IDENTIFIED BY ITS INTEGER COORDINATES ON THE
+// EQUALLY SPACED LATTICE OF THE REFERENCE ELEMENT, WHICH MAKES CONVERTING
+// BETWEEN DIFFERENT ORDERINGS A MATTER OF MATCHING LATTICE POINTS.
+namespace postmesh_io {
+
+typedef std::array<Integer,3> LatticePoint;
+
+ALWAYS_INLINE LatticePoint lattice_point(Integer i, Integer j=0, Integer k=0)
+{
+    LatticePoint point = {{i,j,k}};
+    return point;
+}
+
+ALWAYS_INLINE LatticePoint lattice_axpy(const LatticePoint &a, Integer s, const LatticePoint &x)
+{
+    //! a + s*x
+    return lattice_point(a[0]+s*x[0],a[1]+s*x[1],a[2]+s*x[2]);
+}
+
+ALWAYS_INLINE LatticePoint lattice_direction(const LatticePoint &from, const LatticePoint &to, Integer p)
+{
+    //! UNIT LATTICE STEP ALONG THE EDGE from -> to OF AN ELEMENT OF DEGREE p
+    return lattice_point((to[0]-from[0])/p,(to[1]-from[1])/p,(to[2]-from[2])/p);
+}
+
+ALWAYS_INLINE Integer NbElementVertices(const std::string &element_type)
+{
+    if (element_type=="line") return 2;
+    if (element_type=="tri") return 3;
+    if (element_type=="quad") return 4;
+    if (element_type=="tet") return 4;
+    if (element_type=="hex") return 8;
+    throw std::invalid_argument("Unknown element type "+element_type);
+}
+
+inline Integer NbElementNodes(const std::string &element_type, Integer p)
+{
+    //! NUMBER OF NODES OF A COMPLETE LAGRANGE ELEMENT OF DEGREE p
+    if (element_type=="line") return p+1;
+    if (element_type=="tri") return (p+1)*(p+2)/2;
+    if (element_type=="quad") return (p+1)*(p+1);
+    if (element_type=="tet") return (p+1)*(p+2)*(p+3)/6;
+    if (element_type=="hex") return (p+1)*(p+1)*(p+1);
+    throw std::invalid_argument("Unknown element type "+element_type);
+}
+
+inline Integer InferElementDegree(const std::string &element_type, Integer nnodes)
+{
+    //! INVERSE OF NbElementNodes. RETURNS -1 IF nnodes DOES NOT CORRESPOND
+    //! TO A COMPLETE ELEMENT
+    for (Integer p=1; NbElementNodes(element_type,p)<=nnodes; ++p)
+    {
+        if (NbElementNodes(element_type,p)==nnodes) return p;
+    }
+    return -1;
+}
+
+inline std::vector<LatticePoint> ElementVertices(const std::string &element_type, Integer p)
+{
+    //! VERTICES OF THE REFERENCE ELEMENT. THE ORDER IS SHARED BY POSTMESH AND GMSH
+    if (element_type=="line")
+        return {lattice_point(0),lattice_point(p)};
+    if (element_type=="tri")
+        return {lattice_point(0,0),lattice_point(p,0),lattice_point(0,p)};
+    if (element_type=="quad")
+        return {lattice_point(0,0),lattice_point(p,0),lattice_point(p,p),lattice_point(0,p)};
+    if (element_type=="tet")
+        return {lattice_point(0,0,0),lattice_point(p,0,0),lattice_point(0,p,0),lattice_point(0,0,p)};
+    if (element_type=="hex")
+        return {lattice_point(0,0,0),lattice_point(p,0,0),lattice_point(p,p,0),lattice_point(0,p,0),
+                lattice_point(0,0,p),lattice_point(p,0,p),lattice_point(p,p,p),lattice_point(0,p,p)};
+    throw std::invalid_argument("Unknown element type "+element_type);
+}
+
+inline std::vector<LatticePoint> PostMeshNodeArrangement(const std::string &element_type, Integer p)
+{
+    //! POSTMESH ORDERING: THE VERTICES FIRST, FOLLOWED BY THE REMAINING
+    //! LATTICE POINTS IN LEXICOGRAPHIC ORDER WITH THE FIRST COORDINATE
+    //! RUNNING FASTEST
+    std::vector<LatticePoint> points = ElementVertices(element_type,p);
+    const std::vector<LatticePoint> vertices = points;
+    const bool simplex = element_type=="tri" || element_type=="tet";
+    const Integer pj = (element_type=="line") ? 0 : p;
+    const Integer pk = (element_type=="tet" || element_type=="hex") ? p : 0;
+
+    for (Integer k=0; k<=pk; ++k)
+        for (Integer j=0; j<=pj; ++j)
+            for (Integer i=0; i<=p; ++i)
+            {
+                if (simplex && i+j+k>p) continue;
+                const LatticePoint point = lattice_point(i,j,k);
+                if (std::find(vertices.begin(),vertices.end(),point)!=vertices.end()) continue;
+                points.push_back(point);
+            }
+    return points;
+}
+
+inline std::vector<LatticePoint> GmshNodeArrangement(const std::string &element_type, Integer p)
+{
+    //! GMSH ORDERING: VERTICES, THEN EDGE NODES, THEN FACE NODES AND FINALLY
+    //! THE INTERIOR NODES, WHICH ARE ARRANGED RECURSIVELY AS AN ELEMENT OF
+    //! LOWER DEGREE. EDGES AND FACES FOLLOW THE edges_* AND faces_* TABLES
+    //! OF GMSH'S MElement CLASSES
+    if (p==0) return {lattice_point(0,0,0)};
+
+    std::vector<LatticePoint> points = ElementVertices(element_type,p);
+    const std::vector<LatticePoint> v = points;
+
+    std::vector<std::array<Integer,2>> edges;
+    std::vector<std::vector<Integer>> faces;
+    std::string face_type, interior_type = element_type;
+    Integer interior_shift = 1, face_shift = 1;
+    if (element_type=="line") {
+        edges = {{{0,1}}};
+        interior_type = "";
+    }
+    else if (element_type=="tri") {
+        edges = {{{0,1}},{{1,2}},{{2,0}}};
+        interior_shift = 3;
+    }
+    else if (element_type=="quad") {
+        edges = {{{0,1}},{{1,2}},{{2,3}},{{3,0}}};
+        interior_shift = 2;
+    }
+    else if (element_type=="tet") {
+        edges = {{{0,1}},{{1,2}},{{2,0}},{{3,0}},{{3,2}},{{3,1}}};
+        faces = {{0,2,1},{0,1,3},{0,3,2},{3,1,2}};
+        face_type = "tri";
+        face_shift = 3;
+        interior_shift = 4;
+    }
+    else if (element_type=="hex") {
+        edges = {{{0,1}},{{0,3}},{{0,4}},{{1,2}},{{1,5}},{{2,3}},
+                 {{2,6}},{{3,7}},{{4,5}},{{4,7}},{{5,6}},{{6,7}}};
+        faces = {{0,3,2,1},{0,1,5,4},{0,4,7,3},{1,2,6,5},{2,3,7,6},{4,5,6,7}};
+        face_type = "quad";
+        face_shift = 2;
+        interior_shift = 2;
+    }
+    else {
+        throw std::invalid_argument("Unknown element type "+element_type);
+    }
+
+    if (p<2) return points;
+
+    for (auto &edge: edges)
+    {
+        const LatticePoint u = lattice_direction(v[edge[0]],v[edge[1]],p);
+        for (Integer i=1; i<p; ++i)
+            points.push_back(lattice_axpy(v[edge[0]],i,u));
+    }
+
+    if (!faces.empty() && p>face_shift-1)
+    {
+        const std::vector<LatticePoint> dudv = GmshNodeArrangement(face_type,p-face_shift);
+        for (auto &face: faces)
+        {
+            // THE SECOND AND LAST FACE VERTICES SPAN THE FACE
+            const LatticePoint u = lattice_direction(v[face[0]],v[face[1]],p);
+            const LatticePoint w = lattice_direction(v[face[0]],v[face.back()],p);
+            for (auto &uv: dudv)
+                points.push_back(lattice_axpy(lattice_axpy(v[face[0]],uv[0]+1,u),uv[1]+1,w));
+        }
+    }
+
+    if (!interior_type.empty() && p>interior_shift-1)
+    {
+        const std::vector<LatticePoint> interior = GmshNodeArrangement(interior_type,p-interior_shift);
+        const Integer dim = (element_type=="tet" || element_type=="hex") ? 3 : 2;
+        for (auto point: interior)
+        {
+            for (Integer d=0; d<dim; ++d) point[d] += 1;
+            points.push_back(point);
+        }
+    }
+
+    return points;
+}
+
+inline std::vector<LatticePoint> VTKNodeArrangement(const std::string &element_type, Integer p)
+{
+    //! ORDERING OF VTK'S LAGRANGE CELLS (VTU FILE VERSION 2.2): VERTICES,
+    //! THEN EDGE NODES, THEN FACE NODES AND FINALLY THE INTERIOR NODES.
+    //! SIMPLICES ARE ARRANGED RECURSIVELY, TENSOR PRODUCT CELLS LIST FACE
+    //! AND INTERIOR NODES LEXICOGRAPHICALLY IN THE LATTICE COORDINATES
+    if (p==0) return {lattice_point(0,0,0)};
+
+    std::vector<LatticePoint> points = ElementVertices(element_type,p);
+    const std::vector<LatticePoint> v = points;
+
+    std::vector<std::array<Integer,2>> edges;
+    std::vector<std::vector<Integer>> faces;
+    if (element_type=="line") {
+        edges = {{{0,1}}};
+    }
+    else if (element_type=="tri") {
+        edges = {{{0,1}},{{1,2}},{{2,0}}};
+    }
+    else if (element_type=="quad") {
+        edges = {{{0,1}},{{1,2}},{{3,2}},{{0,3}}};
+    }
+    else if (element_type=="tet") {
+        edges = {{{0,1}},{{1,2}},{{2,0}},{{0,3}},{{1,3}},{{2,3}}};
+        faces = {{0,1,3},{1,2,3},{0,2,3},{0,1,2}};
+    }
+    else if (element_type=="hex") {
+        edges = {{{0,1}},{{1,2}},{{3,2}},{{0,3}},{{4,5}},{{5,6}},
+                 {{7,6}},{{4,7}},{{0,4}},{{1,5}},{{2,6}},{{3,7}}};
+        faces = {{0,3,7,4},{1,2,6,5},{0,1,5,4},{3,2,6,7},{0,1,2,3},{4,5,6,7}};
+    }
+    else {
+        throw std::invalid_argument("Unknown element type "+element_type);
+    }
+
+    if (p<2) return points;
+
+    for (auto &edge: edges)
+    {
+        const LatticePoint u = lattice_direction(v[edge[0]],v[edge[1]],p);
+        for (Integer i=1; i<p; ++i)
+            points.push_back(lattice_axpy(v[edge[0]],i,u));
+    }
+
+    const bool simplex = element_type=="tri" || element_type=="tet";
+    for (auto &face: faces)
+    {
+        // THE SECOND AND LAST FACE VERTICES SPAN THE FACE
+        const LatticePoint u = lattice_direction(v[face[0]],v[face[1]],p);
+        const LatticePoint w = lattice_direction(v[face[0]],v[face.back()],p);
+        if (simplex)
+        {
+            if (p<3) continue;
+            for (auto &uv: VTKNodeArrangement("tri",p-3))
+                points.push_back(lattice_axpy(lattice_axpy(v[face[0]],uv[0]+1,u),uv[1]+1,w));
+        }
+        else
+        {
+            for (Integer j=1; j<p; ++j)
+                for (Integer i=1; i<p; ++i)
+                    points.push_back(lattice_axpy(lattice_axpy(v[face[0]],i,u),j,w));
+        }
+    }
+
+    if (element_type=="tri" && p>2)
+    {
+        for (auto point: VTKNodeArrangement("tri",p-3))
+            points.push_back(lattice_point(point[0]+1,point[1]+1));
+    }
+    else if (element_type=="tet" && p>3)
+    {
+        for (auto point: VTKNodeArrangement("tet",p-4))
+            points.push_back(lattice_point(point[0]+1,point[1]+1,point[2]+1));
+    }
+    else if (element_type=="quad" || element_type=="hex")
+    {
+        const Integer pk = element_type=="hex" ? p-1 : 1;
+        for (Integer k=1; k<=pk; ++k)
+            for (Integer j=1; j<p; ++j)
+                for (Integer i=1; i<p; ++i)
+                    points.push_back(lattice_point(i,j,element_type=="hex" ? k : 0));
+    }
+
+    return points;
+}
+
+inline std::vector<Integer> NodePermutation(const std::vector<LatticePoint> &from, const std::vector<LatticePoint> &to)
+{
+    //! FOR EVERY NODE OF THE to ARRANGEMENT, ITS POSITION IN THE from ARRANGEMENT,
+    //! I.E. to_nodes[i] = from_nodes[permutation[i]]
+    if (from.size()!=to.size())
+        throw std::invalid_argument("Node arrangements of different sizes");
+
+    std::map<LatticePoint,Integer> lookup;
+    for (size_t i=0; i<from.size(); ++i) lookup[from[i]] = i;
+
+    std::vector<Integer> permutation(to.size());
+    for (size_t i=0; i<to.size(); ++i)
+    {
+        auto it = lookup.find(to[i]);
+        if (it==lookup.end())
+            throw std::invalid_argument("Node arrangements span different lattices");
+        permutation[i] = it->second;
+    }
+    return permutation;
+}
+
+ALWAYS_INLINE std::vector<Integer> GmshToPostMeshPermutation(const std::string &element_type, Integer p)
+{
+    return NodePermutation(GmshNodeArrangement(element_type,p),PostMeshNodeArrangement(element_type,p));
+}
+
+ALWAYS_INLINE std::vector<Integer> PostMeshToVTKPermutation(const std::string &element_type, Integer p)
+{
+    return NodePermutation(PostMeshNodeArrangement(element_type,p),VTKNodeArrangement(element_type,p));
+}
+
+inline std::vector<std::vector<Integer>> ElementBoundaryVertices(const std::string &element_type)
+{
+    //! LOCAL VERTICES OF THE FACES (3D) OR EDGES (2D) OF AN ELEMENT, ORIENTED
+    //! SUCH THAT THEIR NORMALS POINT OUT OF THE ELEMENT
+    if (element_type=="tri")
+        return {{0,1},{1,2},{2,0}};
+    if (element_type=="quad")
+        return {{0,1},{1,2},{2,3},{3,0}};
+    if (element_type=="tet")
+        return {{0,2,1},{0,1,3},{0,3,2},{1,2,3}};
+    if (element_type=="hex")
+        return {{0,3,2,1},{0,1,5,4},{0,4,7,3},{1,2,6,5},{2,3,7,6},{4,5,6,7}};
+    throw std::invalid_argument("Unknown element type "+element_type);
+}
+
+ALWAYS_INLINE std::string ElementBoundaryType(const std::string &element_type)
+{
+    if (element_type=="tet") return "tri";
+    if (element_type=="hex") return "quad";
+    return "line";
+}
+
+inline std::vector<std::vector<Integer>> BoundaryNodeArrangement(const std::string &element_type, Integer p)
+{
+    //! FOR EVERY FACE (3D) OR EDGE (2D) OF AN ELEMENT OF DEGREE p, THE LOCAL
+    //! ELEMENT NODES THAT LIE ON IT, LISTED IN POSTMESH ORDERING OF THE FACE
+    //! OR EDGE WITH THE FACE'S FIRST VERTEX AT ITS LATTICE ORIGIN
+    const std::vector<LatticePoint> element_nodes = PostMeshNodeArrangement(element_type,p);
+    const std::vector<LatticePoint> vertices = ElementVertices(element_type,p);
+    const std::vector<LatticePoint> boundary_nodes = PostMeshNodeArrangement(ElementBoundaryType(element_type),p);
+
+    std::map<LatticePoint,Integer> lookup;
+    for (size_t i=0; i<element_nodes.size(); ++i) lookup[element_nodes[i]] = i;
+
+    std::vector<std::vector<Integer>> arrangement;
+    for (auto &boundary: ElementBoundaryVertices(element_type))
+    {
+        const LatticePoint &origin = vertices[boundary[0]];
+        const LatticePoint u = lattice_direction(origin,vertices[boundary[1]],p);
+        const LatticePoint w = boundary.size() > 2 ?
+            lattice_direction(origin,vertices[boundary.back()],p) : lattice_point(0,0,0);
+
+        std::vector<Integer> nodes;
+        for (auto &node: boundary_nodes)
+            nodes.push_back(lookup.at(lattice_axpy(lattice_axpy(origin,node[0],u),node[1],w)));
+        arrangement.push_back(nodes);
+    }
+    return arrangement;
+}
+
+}
+// end of namespace
+
+// SHORTEN THE NAMESPACE
+namespace pio = postmesh_io;
+
+#endif // NODE_ARRANGEMENT_HPP
@@ -13,7 +13,13 @@
 #endif
 
 #include <AuxFuncs.hpp>
+#include <IOFuncs.hpp>
+#include <GmshReader.hpp>
 #include <PyInterface.hpp>
+#include <PostMeshStats.hpp>
+
+// TYPE OF A CURVE OR SURFACE THAT HAS NOT BEEN DETERMINED YET
+#define POSTMESH_LAZY_TYPE (~UInteger(0))
 
 
 class PostMeshBase
@@ -46,7 +52,7 @@ public:
     PostMeshBase(PostMeshBase&& other) noexcept;
     PostMeshBase& operator=(PostMeshBase&& other) noexcept;
 
-    ALWAYS_INLINE ~PostMeshBase() = default;
+    ~PostMeshBase();
 
     ALWAYS_INLINE void Init(std::string &etype, const UInteger &dim)
     {
@@ -75,24 +81,50 @@ public:
             std::cerr << "Prescribed precision " << precision << " too high. Decrease it." << std::endl;
     }
 
+    ALWAYS_INLINE void SetCADCacheDirectory(const char *directory)
+    {
+        //! OPT-IN CACHE OF TRANSLATED CAD MODELS. ReadIGES/ReadSTEP STORE THE
+        //! SHAPE AS NATIVE BREP IN directory, KEYED BY THE CONTENTS OF THE CAD
+        //! FILE, AND THE ARRAYS DERIVED FROM IT (TYPES, VERTICES, BOUNDING
+        //! BOXES ETC.) IN A BINARY SIDECAR NEXT TO IT, WRITTEN ONCE THE NEXT
+        //! MODEL IS READ OR THE OBJECT IS DESTROYED. LATER RUNS ON THE SAME
+        //! FILE SKIP THE TRANSLATION AND THE EXTRACTION. AN EMPTY directory
+        //! DISABLES THE CACHE
+        this->cad_cache_directory = directory;
+    }
+
     ALWAYS_INLINE void SetProjectionCriteria(UInteger *criteria, const Integer &rows, const Integer &cols)
     {
         this->projection_criteria = Eigen::Map<Eigen::MatrixUI>(criteria,rows,cols);
     }
 
-    ALWAYS_INLINE void SetMeshElements(UInteger *arr, const Integer &rows, const Integer &cols)
+    //! THE SetMesh* SETTERS AND SetNodalSpacing COPY THE CALLER'S BUFFER, UNLESS
+    //! borrow IS SET, IN WHICH CASE THE BUFFER IS REFERRED TO IN PLACE AND MUST
+    //! OUTLIVE THIS OBJECT (SEE Eigen::BorrowableMatrix). BORROWED MESH POINTS
+    //! ARE COPIED THE FIRST TIME POSTMESH MODIFIES THEM
+    ALWAYS_INLINE void SetMeshElements(IndexUI *arr, const Integer &rows, const Integer &cols, bool borrow=false)
     {
+        if (borrow)
+        {
+            this->mesh_elements.Borrow(arr,rows,cols);
+            return;
+        }
     #if !defined(WRAP_DATA)
-        this->mesh_elements = Eigen::Map<Eigen::MatrixUI>(arr,rows,cols);
+        this->mesh_elements = Eigen::Map<Eigen::MatrixIndexUI>(arr,rows,cols);
     #else
-        Eigen::WrapRawBuffer<UInteger> Wrapper;
+        Eigen::WrapRawBuffer<IndexUI> Wrapper;
         Wrapper.data = arr;    Wrapper.rows = rows;    Wrapper.cols = cols;
         this->mesh_elements = std::move(Wrapper.asPostMeshMatrix());
     #endif
     }
 
-    ALWAYS_INLINE void SetMeshPoints(Real *arr, const Integer &rows, const Integer &cols)
+    ALWAYS_INLINE void SetMeshPoints(Real *arr, const Integer &rows, const Integer &cols, bool borrow=false)
     {
+        if (borrow)
+        {
+            this->mesh_points.Borrow(arr,rows,cols);
+            return;
+        }
     #if !defined(WRAP_DATA)
         this->mesh_points = Eigen::Map<Eigen::MatrixR>(arr,rows,cols);
     #else
@@ -102,23 +134,33 @@ public:
     #endif
     }
 
-    ALWAYS_INLINE void SetMeshEdges(UInteger *arr, const Integer &rows, const Integer &cols)
+    ALWAYS_INLINE void SetMeshEdges(IndexUI *arr, const Integer &rows, const Integer &cols, bool borrow=false)
     {
+        if (borrow)
+        {
+            this->mesh_edges.Borrow(arr,rows,cols);
+            return;
+        }
     #if !defined(WRAP_DATA)
-        this->mesh_edges = Eigen::Map<Eigen::MatrixUI>(arr,rows,cols);
+        this->mesh_edges = Eigen::Map<Eigen::MatrixIndexUI>(arr,rows,cols);
     #else
-        Eigen::WrapRawBuffer<UInteger> Wrapper;
+        Eigen::WrapRawBuffer<IndexUI> Wrapper;
         Wrapper.data = arr;    Wrapper.rows = rows;    Wrapper.cols = cols;
         this->mesh_edges = std::move(Wrapper.asPostMeshMatrix());
     #endif
     }
 
-    ALWAYS_INLINE void SetMeshFaces(UInteger *arr, const Integer &rows, const Integer &cols)
+    ALWAYS_INLINE void SetMeshFaces(IndexUI *arr, const Integer &rows, const Integer &cols, bool borrow=false)
     {
+        if (borrow)
+        {
+            this->mesh_faces.Borrow(arr,rows,cols);
+            return;
+        }
     #if !defined(WRAP_DATA)
-        this->mesh_faces = Eigen::Map<Eigen::MatrixUI>(arr,rows,cols);
+        this->mesh_faces = Eigen::Map<Eigen::MatrixIndexUI>(arr,rows,cols);
     #else
-        Eigen::WrapRawBuffer<UInteger> Wrapper;
+        Eigen::WrapRawBuffer<IndexUI> Wrapper;
         Wrapper.data = arr;    Wrapper.rows = rows;    Wrapper.cols = cols;
         this->mesh_faces = std::move(Wrapper.asPostMeshMatrix());
     #endif
@@ -126,6 +168,7 @@ public:
 
     ALWAYS_INLINE void ScaleMesh()
     {
+        this->mesh_points.MakeWritable();
         this->mesh_points *=this->scale;
     }
 
@@ -134,8 +177,13 @@ public:
         return this->mesh_element_type;
     }
 
-    ALWAYS_INLINE void SetNodalSpacing(Real *arr, const Integer &rows, const Integer &cols)
+    ALWAYS_INLINE void SetNodalSpacing(Real *arr, const Integer &rows, const Integer &cols, bool borrow=false)
     {
+        if (borrow)
+        {
+            this->fekete.Borrow(arr,rows,cols);
+            return;
+        }
     #if !defined(WRAP_DATA)
         this->fekete = Eigen::Map<Eigen::MatrixR>(arr,rows,cols);
     #else
@@ -148,21 +196,35 @@ public:
     ALWAYS_INLINE void ReturnModifiedMeshPoints(Real *points)
     {
         // RETURN MODIFIED MESH POINTS - INVOLVES DEEP COPY
-        Eigen::Map<decltype(this->mesh_points)>(points,
+        Eigen::Map<Eigen::MatrixR>(points,
                                                 this->mesh_points.rows(),
                                                 this->mesh_points.cols()) = this->mesh_points/this->scale;
     }
 
     void ReadIGES(const char *filename);
     void ReadSTEP(const char *filename);
+    void ReadBREP(const char *filename);
+    void ReadCADFiles(const std::vector<std::string> &filenames);
+    void ReadBREPString(const std::string &brep);
+    void SetShape(const TopoDS_Shape &shape);
     static Eigen::MatrixI Read(std::string &filename);
-    static Eigen::MatrixUI ReadI(std::string &filename, char delim);
+    static Eigen::MatrixIndexUI ReadI(std::string &filename, char delim);
     static Eigen::MatrixR ReadR(std::string &filename, char delim);
+    void ReadGmsh(const char *filename);
+    void ReadMeshBinary(const char *filename, bool verify=true);
+    void WriteMeshBinary(const char *filename);
+    void ExtractBoundaryFaces();
+    void ExtractBoundaryEdges();
     void CheckMesh();
 
     void GetGeomVertices();
     void GetGeomEdges();
     void GetGeomFaces();
+    UInteger CurveType(UInteger icurve);
+    UInteger SurfaceType(UInteger isurface);
+    const BRepAdaptor_Surface& SurfaceAdaptor(UInteger isurface);
+    const std::vector<Handle_Geom_Curve>& SurfaceCurves(UInteger isurface);
+    const std::vector<UInteger>& SurfaceCurvesTypes(UInteger isurface);
     std::vector<Real> ObtainGeomVertices();
 
     ALWAYS_INLINE Integer NbPoints()
@@ -182,6 +244,37 @@ public:
 
     void ComputeProjectionCriteria();
     DirichletData GetDirichletData();
+    Integer GetDirichletDataSize();
+    void FillDirichletData(Integer *nodes_dir_out, Real *displacements_BC_out);
+
+    ALWAYS_INLINE const PostMeshStats& GetStats() const
+    {
+        //! PHASE TIMES, PROJECTION COUNTS AND PEAK MEMORY OF THIS OBJECT SO FAR
+        return this->stats;
+    }
+
+    ALWAYS_INLINE void ResetStats()
+    {
+        this->stats.Reset();
+    }
+
+    //! PER NODE WARNINGS OF THE PROJECTION PHASES GO TO diagnostics, WHICH
+    //! AGGREGATES THEM AND WRITES THEM ONCE AT THE END OF EVERY PHASE
+    ALWAYS_INLINE void SetDiagnosticsFile(const char *filename)
+    {
+        this->diagnostics.SetFile(filename);
+    }
+
+    ALWAYS_INLINE void SetDiagnosticsCallback(PostMeshDiagnostics::RawCallback callback, void *context)
+    {
+        this->diagnostics.SetCallback(callback,context);
+    }
+
+    ALWAYS_INLINE void SetDiagnosticsLimits(Integer max_examples, Integer min_severity)
+    {
+        this->diagnostics.SetMaxExamples(max_examples);
+        this->diagnostics.SetMinSeverity(static_cast<Severity>(min_severity));
+    }
 
 
     std::string mesh_element_type;
@@ -189,10 +282,10 @@ public:
     Real scale;
     Real condition;
     Real projection_precision;
-    Eigen::MatrixUI mesh_elements;
-    Eigen::MatrixR mesh_points;
-    Eigen::MatrixUI mesh_edges;
-    Eigen::MatrixUI mesh_faces;
+    Eigen::BorrowableMatrixIndexUI mesh_elements;
+    Eigen::BorrowableMatrixR mesh_points;
+    Eigen::BorrowableMatrixIndexUI mesh_edges;
+    Eigen::BorrowableMatrixIndexUI mesh_faces;
     Eigen::MatrixUI projection_criteria;
 
     UInteger degree;
@@ -205,15 +298,63 @@ public:
     std::vector<UInteger> geometry_curves_types;
     std::vector<UInteger> geometry_surfaces_types;
     std::vector<std::vector<UInteger>> geometry_surfaces_curves_types;
+    // CURVE/SURFACE TYPES ARE POSTMESH_LAZY_TYPE AND THE CURVES OF A SURFACE ARE
+    // EMPTY UNTIL DETERMINED BY THE ACCESSORS ABOVE
     std::vector<TopoDS_Edge> topo_edges;
     std::vector<TopoDS_Face> topo_faces;
+    // SURFACE/CURVE ID OFFSETS OF THE PARTS OF A MODEL READ BY ReadCADFiles
+    std::vector<Integer> parts_surfaces;
+    std::vector<Integer> parts_curves;
     Eigen::MatrixR displacements_BC;
-    Eigen::MatrixI index_nodes;
-    Eigen::MatrixUI nodes_dir;
-    Eigen::MatrixR fekete;
-
+    Eigen::MatrixIndexUI nodes_dir;
+    Eigen::MatrixR projection_residuals;
+    Eigen::BorrowableMatrixR fekete;
+    // KEEPS A MESH LOADED BY ReadMeshBinary MAPPED WHILE IT IS BORROWED
+    std::shared_ptr<pio::BinaryFile> binary_mesh;
+    // CAD CACHE DIRECTORY, KEY OF THE CURRENT CAD FILE AND MAPPED SIDECAR
+    std::string cad_cache_directory;
+    std::string cad_cache_key;
+    std::shared_ptr<pio::BinaryFile> cad_cache;
+    // ARRAYS DERIVED FROM THE CURRENT CAD MODEL THAT ARE NOT IN THE SIDECAR YET
+    std::vector<std::pair<pio::ArrayDescriptor,std::vector<char>>> cad_cache_pending;
+    PostMeshStats stats;
+    PostMeshDiagnostics diagnostics;
+
+
+protected:
+    std::vector<bool> surfaces_curves_materialised;
+    std::vector<std::shared_ptr<BRepAdaptor_Surface>> surfaces_adaptors;
+
+    void ResetGeometry();
+    void IndexGeometry();
+    void MaterialiseSurfaceCurves(UInteger isurface);
+    bool ReadCADCache(const char *filename);
+    void WriteCADCacheShape();
+    const pio::ArrayRecord* FindCADCache(const char *name, std::uint32_t dtype, Integer rows=-1, Integer cols=-1);
+    void UpdateCADCache(const std::vector<pio::ArrayDescriptor> &arrays);
+    void FlushCADCache();
+    void WriteCurvedMeshVTU(const char *filename, const Eigen::Ref<const Eigen::MatrixIndexUI> &boundary,
+                            const std::vector<Integer> &listboundary, const Eigen::MatrixIndexI &dirichlet,
+                            const char *id_name);
+
+    ALWAYS_INLINE void InvalidateDirichletData()
+    {
+        //! FORGET THE UNIQUE DIRICHLET NODES FOUND BY GetDirichletDataSize.
+        //! MUST BE CALLED WHENEVER nodes_dir OR displacements_BC ARE REASSIGNED
+        this->dirichlet_unique.clear();
+        this->dirichlet_unique_valid = false;
+    }
 
 private:
+    // FIRST OCCURRENCES OF THE UNIQUE DIRICHLET NODES IN nodes_dir, BETWEEN
+    // GetDirichletDataSize AND FillDirichletData, AND WHETHER THEY STILL
+    // DESCRIBE THE CURRENT nodes_dir
+    std::vector<Integer> dirichlet_unique;
+    bool dirichlet_unique_valid = false;
+
+    Integer UniqueDirichletNodes();
+    void WriteDirichletData(Integer *nodes_dir_out, Real *displacements_BC_out);
+
     void SetDimension(const UInteger &dim)
     {
         this->ndim=dim;
@@ -48,6 +48,7 @@ public:
     void MeshPointInversionCurveArcLength();
     void MeshPointInversionCurve();
     void GetBoundaryPointsOrder();
+    void WriteVTU(const char *filename);
 
 
     // PUBLIC DATA MEMBERS OF PostMeshCurve
@@ -71,7 +72,7 @@ protected:
 
     Eigen::MatrixR projection_U;
     Eigen::MatrixI sorted_projected_indices;
-    Eigen::MatrixI dirichlet_edges;
+    Eigen::MatrixIndexI dirichlet_edges;
     std::vector<Integer> listedges;
     Standard_Integer no_dir_edges;
     Eigen::MatrixR u_of_all_fekete_mesh_edges;
@@ -0,0 +1,189 @@
+#ifndef POSTMESH_DIAGNOSTICS_HPP
+#define POSTMESH_DIAGNOSTICS_HPP
+
+#include <STL_INC.hpp>
+#include <functional>
+#include <cstring>
+
+
+enum Severity : int
+{
+    SEVERITY_INFO = 0,
+    SEVERITY_WARNING = 1,
+    SEVERITY_ERROR = 2
+};
+
+ALWAYS_INLINE const char *SeverityName(Severity severity)
+{
+    switch (severity)
+    {
+        case SEVERITY_INFO: return "Info";
+        case SEVERITY_WARNING: return "Warning";
+        default: return "Error";
+    }
+}
+
+struct DiagnosticRecord
+{
+    //! ALL REPORTS OF ONE KIND OF MESSAGE SINCE THE LAST FLUSH. ONLY THE
+    //! DETAILS OF THE FIRST FEW ARE FORMATTED AND KEPT
+    Severity severity;
+    std::string kind;
+    Integer count;
+    std::vector<std::string> examples;
+};
+
+class PostMeshDiagnostics
+{
+    //! DIAGNOSTICS SINK FOR HOT LOOPS. REPORTS ARE AGGREGATED BY KIND AND
+    //! WRITTEN ONCE PER PHASE, AS ONE RECORD PER KIND WITH ITS COUNT AND
+    //! EXAMPLES, TO A CALLBACK, TO A FILE OR ELSE TO std::cerr. LIKE
+    //! PostMeshStats IT IS NOT THREAD SAFE, CONCURRENT CODE REPORTS INTO A
+    //! LOCAL SINK AND MERGES IT AFTERWARDS
+public:
+    typedef std::function<void(const std::string &phase, const DiagnosticRecord &record)> Callback;
+    typedef void (*RawCallback)(void *context, const std::string &phase, const DiagnosticRecord &record);
+
+    ALWAYS_INLINE void SetCallback(Callback callback)
+    {
+        this->callback = std::move(callback);
+    }
+
+    ALWAYS_INLINE void SetCallback(RawCallback callback, void *context)
+    {
+        //! C STYLE CALLBACK, E.G. FROM THE PYTHON BINDINGS. A NULL CALLBACK
+        //! RESTORES THE DEFAULT OUTPUT
+        if (callback == nullptr)
+            this->callback = nullptr;
+        else
+            this->callback = [callback,context](const std::string &phase, const DiagnosticRecord &record) {
+                callback(context,phase,record);
+            };
+    }
+
+    ALWAYS_INLINE void SetFile(const std::string &filename)
+    {
+        //! APPEND RECORDS TO A FILE. AN EMPTY NAME RESTORES THE DEFAULT OUTPUT
+        this->filename = filename;
+    }
+
+    ALWAYS_INLINE void SetMaxExamples(Integer max_examples)
+    {
+        this->max_examples = std::max(Integer(0),max_examples);
+    }
+
+    ALWAYS_INLINE void SetMinSeverity(Severity severity)
+    {
+        this->min_severity = severity;
+    }
+
+    template<typename... T>
+    void Report(Severity severity, const char *kind, T&&... details)
+    {
+        //! COUNT A MESSAGE OF THE GIVEN KIND. kind IS A FIXED TEXT, THE PER
+        //! NODE DETAILS ARE ONLY FORMATTED FOR THE FIRST max_examples REPORTS
+        if (severity < this->min_severity) return;
+        DiagnosticRecord &record = this->Find(severity,kind);
+        ++record.count;
+        if (sizeof...(details) && Integer(record.examples.size()) < this->max_examples)
+        {
+            std::ostringstream example;
+            Format(example,std::forward<T>(details)...);
+            record.examples.push_back(example.str());
+        }
+    }
+
+    ALWAYS_INLINE const std::vector<DiagnosticRecord>& Pending() const
+    {
+        return this->records;
+    }
+
+    void Merge(const PostMeshDiagnostics &other)
+    {
+        for (const auto &other_record: other.records)
+        {
+            DiagnosticRecord &record = this->Find(other_record.severity,other_record.kind.c_str());
+            record.count += other_record.count;
+            for (const auto &example: other_record.examples)
+            {
+                if (Integer(record.examples.size()) >= this->max_examples) break;
+                record.examples.push_back(example);
+            }
+        }
+    }
+
+    void Flush(const std::string &phase)
+    {
+        //! WRITE AND FORGET THE RECORDS GATHERED SO FAR. THE RECORDS ARE TAKEN
+        //! OUT FIRST, SO AN EXCEPTION FROM THE CALLBACK DROPS THEM RATHER THAN
+        //! REPORTING THEM AGAIN WITH THE NEXT PHASE
+        if (this->records.empty()) return;
+        std::vector<DiagnosticRecord> flushed;
+        flushed.swap(this->records);
+
+        if (this->callback)
+        {
+            for (const auto &record: flushed)
+                this->callback(phase,record);
+        }
+        else if (!this->filename.empty())
+        {
+            std::ofstream out(this->filename,std::ios::app);
+            if (!out)
+            {
+                std::cerr << "Could not open diagnostics file " << this->filename << std::endl;
+                Write(std::cerr,phase,flushed);
+            }
+            else
+                Write(out,phase,flushed);
+        }
+        else
+            Write(std::cerr,phase,flushed);
+    }
+
+private:
+    ALWAYS_INLINE static void Format(std::ostringstream &) {}
+
+    template<typename U, typename... T>
+    ALWAYS_INLINE static void Format(std::ostringstream &out, U&& first, T&&... rest)
+    {
+        out << first;
+        if (sizeof...(rest)) out << " ";
+        Format(out,std::forward<T>(rest)...);
+    }
+
+    static void Write(std::ostream &out, const std::string &phase, const std::vector<DiagnosticRecord> &records)
+    {
+        for (const auto &record: records)
+        {
+            out << SeverityName(record.severity) << " [" << phase << "] " << record.kind;
+            if (record.count > 1)
+                out << " (" << record.count << " times)";
+            out << "\n";
+            for (const auto &example: record.examples)
+                out << "    " << example << "\n";
+            if (record.count > Integer(record.examples.size()) && !record.examples.empty())
+                out << "    ...\n";
+        }
+        out.flush();
+    }
+
+    DiagnosticRecord &Find(Severity severity, const char *kind)
+    {
+        for (auto &record: this->records)
+        {
+            if (record.severity == severity && std::strcmp(record.kind.c_str(),kind) == 0)
+                return record;
+        }
+        this->records.push_back(DiagnosticRecord{severity,kind,0,{}});
+        return this->records.back();
+    }
+
+    std::vector<DiagnosticRecord> records;
+    Callback callback;
+    std::string filename;
+    Integer max_examples = 5;
+    Severity min_severity = SEVERITY_WARNING;
+};
+
+#endif // POSTMESH_DIAGNOSTICS_HPP
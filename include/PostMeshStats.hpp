@@ -0,0 +1,233 @@
+#ifndef POSTMESH_STATS_HPP
+#define POSTMESH_STATS_HPP
+
+#include <STL_INC.hpp>
+#include <PostMeshTrace.hpp>
+#include <PostMeshDiagnostics.hpp>
+#include <functional>
+
+#ifndef _WIN32
+    #include <sys/resource.h>
+#endif
+
+
+ALWAYS_INLINE Integer PeakRSS()
+{
+    //! PEAK RESIDENT SET SIZE OF THE PROCESS IN BYTES, 0 IF UNAVAILABLE
+#ifdef _WIN32
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF,&usage) != 0) return 0;
+#ifdef __APPLE__
+    return Integer(usage.ru_maxrss);
+#else
+    return Integer(usage.ru_maxrss)*1024;
+#endif
+#endif
+}
+
+struct SurfaceCost
+{
+    //! COST OF THE OCC CALLS MADE ON ONE CAD SURFACE. TIMES ARE WALL TIMES IN
+    //! SECONDS, THE RESIDUAL IS THE LARGEST DISTANCE A MESH NODE WAS MOVED TO
+    //! REACH THE SURFACE, IN MESH UNITS
+    Real identification_time = 0.;
+    Real projection_time = 0.;
+    Real inversion_time = 0.;
+    // POINT PROJECTIONS OF ANY ALGORITHM AND THOSE THAT THREW StdFail_NotDone
+    Integer projections = 0;
+    Integer failures = 0;
+    // OCC DOES NOT REPORT THE ITERATIONS OF Extrema_ExtPS, THE NUMBER OF
+    // EXTREMA IT CONVERGED TO IS KEPT INSTEAD
+    Integer extrema_calls = 0;
+    Integer extrema_solutions = 0;
+    Real worst_residual = 0.;
+
+    ALWAYS_INLINE Real TotalTime() const
+    {
+        return this->identification_time + this->projection_time + this->inversion_time;
+    }
+
+    ALWAYS_INLINE Real MeanExtremaSolutions() const
+    {
+        return this->extrema_calls ? Real(this->extrema_solutions)/this->extrema_calls : 0.;
+    }
+
+    ALWAYS_INLINE void Merge(const SurfaceCost &other)
+    {
+        this->identification_time += other.identification_time;
+        this->projection_time += other.projection_time;
+        this->inversion_time += other.inversion_time;
+        this->projections += other.projections;
+        this->failures += other.failures;
+        this->extrema_calls += other.extrema_calls;
+        this->extrema_solutions += other.extrema_solutions;
+        this->worst_residual = std::max(this->worst_residual,other.worst_residual);
+    }
+};
+
+struct PostMeshStats
+{
+    //! RUN STATISTICS OF A POSTMESH OBJECT. PHASE TIMES ARE INCLUSIVE WALL
+    //! TIMES IN SECONDS, ACCUMULATED OVER REPEATED CALLS AND KEPT IN THE
+    //! ORDER THE PHASES FIRST RAN. COUNTERS ARE PLAIN INTEGERS UPDATED FROM
+    //! SERIAL CODE; CONCURRENT CODE COUNTS INTO A LOCAL PostMeshStats AND
+    //! MERGES IT AFTERWARDS
+    std::vector<std::pair<std::string,Real> > phases;
+
+    // OCC PROJECTIONS BY ALGORITHM
+    Integer projections_on_curve = 0;       // GeomAPI_ProjectPointOnCurve
+    Integer projections_on_surface = 0;     // GeomAPI_ProjectPointOnSurf
+    Integer extrema_on_surface = 0;         // Extrema_ExtPS
+    Integer newton_on_curve = 0;            // ShapeAnalysis_Curve
+
+    // PROJECTIONS THAT THREW StdFail_NotDone
+    Integer projection_failures = 0;
+    // MESH NODES SNAPPED TO A CAD VERTEX BEFORE PROJECTION
+    Integer vertex_snaps = 0;
+    // MESH FACES/EDGES FOR WHICH NO UNIQUE SURFACE/CURVE WAS FOUND
+    Integer unresolved_faces = 0;
+    // PEAK RESIDENT SET SIZE IN BYTES, SAMPLED AT THE END OF EVERY PHASE
+    Integer peak_rss = 0;
+    // COST PROFILE INDEXED BY CAD SURFACE, ONLY AS LONG AS THE LARGEST
+    // SURFACE ID THAT HAS BEEN WORKED ON
+    std::vector<SurfaceCost> surfaces;
+
+    ALWAYS_INLINE void AddPhase(const std::string &name, Real seconds)
+    {
+        for (auto &phase: this->phases)
+        {
+            if (phase.first == name)
+            {
+                phase.second += seconds;
+                return;
+            }
+        }
+        this->phases.emplace_back(name,seconds);
+    }
+
+    ALWAYS_INLINE Real PhaseTime(const std::string &name) const
+    {
+        for (const auto &phase: this->phases)
+            if (phase.first == name) return phase.second;
+        return 0.;
+    }
+
+    ALWAYS_INLINE SurfaceCost &Surface(Integer isurface)
+    {
+        if (isurface >= Integer(this->surfaces.size()))
+            this->surfaces.resize(isurface+1);
+        return this->surfaces[isurface];
+    }
+
+    std::vector<Integer> SurfaceOrder(const std::string &sort_by="time") const
+    {
+        //! SURFACE IDS, MOST EXPENSIVE FIRST BY ONE OF time, identification_time,
+        //! projection_time, inversion_time, projections, failures, extrema
+        //! (MEAN EXTREMA PER CALL) OR residual
+        std::function<Real(const SurfaceCost&)> key;
+        if (sort_by=="time") key = [](const SurfaceCost &c) { return c.TotalTime(); };
+        else if (sort_by=="identification_time") key = [](const SurfaceCost &c) { return c.identification_time; };
+        else if (sort_by=="projection_time") key = [](const SurfaceCost &c) { return c.projection_time; };
+        else if (sort_by=="inversion_time") key = [](const SurfaceCost &c) { return c.inversion_time; };
+        else if (sort_by=="projections") key = [](const SurfaceCost &c) { return Real(c.projections); };
+        else if (sort_by=="failures") key = [](const SurfaceCost &c) { return Real(c.failures); };
+        else if (sort_by=="extrema") key = [](const SurfaceCost &c) { return c.MeanExtremaSolutions(); };
+        else if (sort_by=="residual") key = [](const SurfaceCost &c) { return c.worst_residual; };
+        else throw std::invalid_argument("Unknown surface profile key "+sort_by);
+
+        std::vector<Integer> order(this->surfaces.size());
+        std::iota(order.begin(),order.end(),0);
+        std::stable_sort(order.begin(),order.end(),[&](Integer a, Integer b) {
+            return key(this->surfaces[a]) > key(this->surfaces[b]);
+        });
+        return order;
+    }
+
+    ALWAYS_INLINE void Merge(const PostMeshStats &other)
+    {
+        for (const auto &phase: other.phases)
+            this->AddPhase(phase.first,phase.second);
+        this->projections_on_curve += other.projections_on_curve;
+        this->projections_on_surface += other.projections_on_surface;
+        this->extrema_on_surface += other.extrema_on_surface;
+        this->newton_on_curve += other.newton_on_curve;
+        this->projection_failures += other.projection_failures;
+        this->vertex_snaps += other.vertex_snaps;
+        this->unresolved_faces += other.unresolved_faces;
+        this->peak_rss = std::max(this->peak_rss,other.peak_rss);
+        for (UInteger isurface=0; isurface<other.surfaces.size(); ++isurface)
+            this->Surface(isurface).Merge(other.surfaces[isurface]);
+    }
+
+    ALWAYS_INLINE void Reset()
+    {
+        *this = PostMeshStats();
+    }
+};
+
+class PostMeshTimer
+{
+    //! SCOPED TIMER THAT ADDS ITS LIFETIME IN SECONDS TO A COUNTER
+public:
+    ALWAYS_INLINE PostMeshTimer(Real &seconds) :
+        seconds(seconds), start(std::chrono::steady_clock::now()) {}
+
+    ALWAYS_INLINE ~PostMeshTimer()
+    {
+        const std::chrono::duration<Real> elapsed = std::chrono::steady_clock::now() - this->start;
+        this->seconds += elapsed.count();
+    }
+
+    PostMeshTimer(const PostMeshTimer&) = delete;
+    PostMeshTimer& operator=(const PostMeshTimer&) = delete;
+
+private:
+    Real &seconds;
+    std::chrono::steady_clock::time_point start;
+};
+
+class PostMeshPhase
+{
+    //! SCOPED TIMER THAT ADDS ITS LIFETIME TO A PHASE OF A PostMeshStats,
+    //! AND TO THE TIMELINE IF TRACING IS ENABLED. IF A DIAGNOSTICS SINK IS
+    //! GIVEN IT IS FLUSHED WHEN THE PHASE ENDS
+public:
+    ALWAYS_INLINE PostMeshPhase(PostMeshStats &stats, const char *name, PostMeshDiagnostics *diagnostics=nullptr) :
+        stats(stats), name(name), diagnostics(diagnostics), start(std::chrono::steady_clock::now()), trace(name,"phase") {}
+
+    ALWAYS_INLINE ~PostMeshPhase()
+    {
+        //! A DESTRUCTOR MUST NOT THROW. A FAILING DIAGNOSTICS CALLBACK, OUTPUT
+        //! OR ALLOCATION WHILE CLOSING THE PHASE IS REPORTED AND SWALLOWED
+        try
+        {
+            const std::chrono::duration<Real> elapsed = std::chrono::steady_clock::now() - this->start;
+            this->stats.AddPhase(this->name,elapsed.count());
+            this->stats.peak_rss = std::max(this->stats.peak_rss,PeakRSS());
+            if (this->diagnostics != nullptr)
+                this->diagnostics->Flush(this->name);
+        }
+        catch (std::exception &error)
+        {
+            std::cerr << "Error closing PostMesh phase " << this->name << ": " << error.what() << std::endl;
+        }
+        catch (...)
+        {
+            std::cerr << "Error closing PostMesh phase " << this->name << std::endl;
+        }
+    }
+
+    PostMeshPhase(const PostMeshPhase&) = delete;
+    PostMeshPhase& operator=(const PostMeshPhase&) = delete;
+
+private:
+    PostMeshStats &stats;
+    const char *name;
+    PostMeshDiagnostics *diagnostics;
+    std::chrono::steady_clock::time_point start;
+    PostMeshTraceScope trace;
+};
+
+#endif // POSTMESH_STATS_HPP
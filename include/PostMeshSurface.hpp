@@ -51,6 +51,8 @@ public:
     void GetBoundingBoxOnSurfaces(Real bb_tolerance=1e-3);
     std::vector< std::vector<Integer> > GetMeshFacesOnPlanarSurfaces();
     std::vector<Integer> GetDirichletFaces();
+    void WriteVTU(const char *filename);
+    void WriteSurfaceProfile(const char *filename, const std::string &sort_by="time");
 
 
     std::vector<Eigen::MatrixR> geometry_points_on_surfaces;
@@ -58,16 +60,17 @@ public:
     Eigen::MatrixI boundary_faces_order;
     Eigen::MatrixR surfaces_Uparameters;
     Eigen::MatrixR surfaces_Vparameters;
+    // BOUNDING BOXES ARE ONLY VALID FOR SURFACES THAT HAVE BEEN MATERIALISED
     Eigen::MatrixR bbox_surfaces;
 
 protected:
 
-    Eigen::MatrixI projection_ID;
+    Eigen::MatrixIndexI projection_ID;
     Eigen::MatrixR projection_U;
     Eigen::MatrixR projection_V;
     Eigen::MatrixI sorted_projected_indicesU;
     Eigen::MatrixI sorted_projected_indicesV;
-    Eigen::MatrixI dirichlet_faces;
+    Eigen::MatrixIndexI dirichlet_faces;
     std::vector<Integer> listfaces;
     Integer no_dir_faces;
     Eigen::MatrixI elements_with_boundary_faces;
@@ -85,7 +88,18 @@ protected:
             return -1;
         }
     }
+    std::vector<bool> bbox_surfaces_materialised;
+    Real bbox_tolerance = 1e-3;
+
     std::vector<Boolean> FindPlanarSurfaces();
+    void MaterialiseBoundingBox(UInteger isurface);
+    bool InBoundingBox(UInteger isurface, const Eigen::Ref<const Eigen::RowVectorR> &point);
+
+    // FACE LOOPS SPECIALISED ON THE NUMBER OF FACE VERTICES NV
+    template<Integer NV> Integer IdentifySurfacesContainingFacesKernel(Integer activate_bounding_box);
+    template<Integer NV> void IdentifyRemainingSurfacesByProjectionKernel(Integer activate_bounding_box);
+    template<Integer NV> Integer IdentifySurfacesContainingFacesByPureProjectionKernel(Integer activate_bounding_box);
+    template<Integer NV> void ProjectMeshOnSurfaceKernel();
 };
 
 #endif // POSTMESHSURFACE_H
@@ -0,0 +1,265 @@
+#ifndef POSTMESH_TRACE_HPP
+#define POSTMESH_TRACE_HPP
+
+#include <STL_INC.hpp>
+
+
+//! OPTIONAL TIMELINE TRACER. WHEN ENABLED, EVERY PostMesh PHASE AND EVERY
+//! BLOCK OF A parallel_for IS RECORDED AS A BEGIN/DURATION EVENT ON THE
+//! THREAD THAT RAN IT, AND THE TIMELINE IS WRITTEN IN THE CHROME TRACE EVENT
+//! FORMAT (chrome://tracing, ui.perfetto.dev). TRACING IS STARTED WITH
+//! StartTrace() OR BY SETTING THE POSTMESH_TRACE ENVIRONMENT VARIABLE TO AN
+//! OUTPUT FILE, IN WHICH CASE THE FILE IS WRITTEN WHEN THE PROCESS EXITS
+
+struct TraceEvent
+{
+    // NAMES AND CATEGORIES ARE STRING LITERALS AND ARE NEVER COPIED
+    const char *name;
+    const char *category;
+    // STEADY CLOCK NANOSECONDS. EVENTS ARE ONLY PUT RELATIVE TO THE START
+    // OF THE TRACE WHEN WRITTEN, SO RECORDING NEVER READS THE EPOCH
+    Integer start;
+    Integer duration;
+    // BLOCK [lo,hi) OF A parallel_for, -1 FOR PHASES
+    Integer lo;
+    Integer hi;
+};
+
+struct TraceBuffer
+{
+    //! SINGLE PRODUCER RING BUFFER. IT IS OWNED BY ONE THREAD AT A TIME, SO
+    //! RECORDING NEEDS NO LOCK. WHEN FULL THE OLDEST EVENTS ARE OVERWRITTEN
+    static constexpr Integer capacity = Integer(1) << 14;
+
+    TraceBuffer(Integer lane) : events(capacity), head(0), lane(lane) {}
+
+    std::vector<TraceEvent> events;
+    std::atomic<Integer> head;
+    // TRACE THREAD ID. BUFFERS ARE RECYCLED WHEN THEIR THREAD EXITS, SO A
+    // LANE IS A WORKER SLOT RATHER THAN A PARTICULAR OS THREAD
+    Integer lane;
+};
+
+class PostMeshTracer
+{
+public:
+    static PostMeshTracer &Instance()
+    {
+        static PostMeshTracer tracer;
+        return tracer;
+    }
+
+    ALWAYS_INLINE static bool Enabled()
+    {
+        return Instance().enabled.load(std::memory_order_relaxed);
+    }
+
+    ALWAYS_INLINE static Integer Now()
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Start()
+    {
+        //! START A NEW TRACE, DISCARDING ANY EVENTS RECORDED SO FAR. SAFE WHILE
+        //! OTHER THREADS ARE TRACING: AN EVENT THEY BEGAN BEFORE THE NEW TRACE
+        //! IS DROPPED WHEN THE TRACE IS WRITTEN
+        std::lock_guard<std::mutex> lock(this->mutex);
+        for (auto &buffer: this->buffers)
+            buffer->head.store(0,std::memory_order_relaxed);
+        this->epoch.store(Now(),std::memory_order_relaxed);
+        this->enabled.store(true,std::memory_order_release);
+    }
+
+    void Stop()
+    {
+        this->enabled.store(false,std::memory_order_release);
+    }
+
+    ALWAYS_INLINE Integer Begin()
+    {
+        //! TIMESTAMP THE START OF AN EVENT. THE CALLING THREAD CLAIMS ITS LANE
+        //! HERE, SO THREADS THAT RUN AT THE SAME TIME NEVER SHARE A LANE
+        this->LocalBuffer();
+        return this->Now();
+    }
+
+    ALWAYS_INLINE void Record(const char *name, const char *category, Integer start, Integer lo, Integer hi)
+    {
+        TraceBuffer &buffer = this->LocalBuffer();
+        const Integer head = buffer.head.load(std::memory_order_relaxed);
+        TraceEvent &event = buffer.events[head & (TraceBuffer::capacity-1)];
+        event.name = name;
+        event.category = category;
+        event.start = start;
+        event.duration = this->Now() - start;
+        event.lo = lo;
+        event.hi = hi;
+        buffer.head.store(head+1,std::memory_order_release);
+    }
+
+    bool Write(const std::string &filename)
+    {
+        //! STOP TRACING AND WRITE THE TIMELINE. MUST NOT BE CALLED WHILE
+        //! PostMesh IS RUNNING ON OTHER THREADS
+        this->Stop();
+        std::ofstream out(filename);
+        if (!out)
+        {
+            std::cerr << "Could not open trace file " << filename << std::endl;
+            return false;
+        }
+
+        std::vector<std::pair<Integer,const TraceEvent*> > events;
+        Integer dropped = 0;
+        std::lock_guard<std::mutex> lock(this->mutex);
+        const Integer epoch = this->epoch.load(std::memory_order_relaxed);
+        for (const auto &buffer: this->buffers)
+        {
+            const Integer head = buffer->head.load(std::memory_order_acquire);
+            const Integer first = std::max(Integer(0),head-TraceBuffer::capacity);
+            dropped += first;
+            for (Integer i=first; i<head; ++i)
+            {
+                const TraceEvent &event = buffer->events[i & (TraceBuffer::capacity-1)];
+                if (event.start >= epoch)
+                    events.emplace_back(buffer->lane,&event);
+            }
+        }
+        std::sort(events.begin(),events.end(),[](const std::pair<Integer,const TraceEvent*> &a,
+                                                 const std::pair<Integer,const TraceEvent*> &b) {
+            return a.second->start < b.second->start;
+        });
+
+        // CHROME TRACE TIMESTAMPS ARE IN MICROSECONDS
+        out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << "},\n";
+        out << "\"traceEvents\":[\n";
+        out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"PostMesh\"}}";
+        for (const auto &buffer: this->buffers)
+        {
+            out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->lane
+                << ",\"args\":{\"name\":\"lane " << buffer->lane << "\"}}";
+        }
+        char timing[64];
+        for (const auto &item: events)
+        {
+            const TraceEvent &event = *item.second;
+            std::snprintf(timing,sizeof(timing),"\"ts\":%.3f,\"dur\":%.3f",(event.start-epoch)*1e-3,event.duration*1e-3);
+            out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                << "\",\"ph\":\"X\"," << timing << ",\"pid\":1,\"tid\":" << item.first;
+            if (event.lo >= 0)
+                out << ",\"args\":{\"lo\":" << event.lo << ",\"hi\":" << event.hi << "}";
+            out << "}";
+        }
+        out << "\n]}\n";
+        return bool(out);
+    }
+
+private:
+    PostMeshTracer() : enabled(false), epoch(Now())
+    {
+        const char *env = std::getenv("POSTMESH_TRACE");
+        if (env != nullptr && *env != '\0')
+        {
+            this->output = env;
+            this->Start();
+        }
+    }
+
+    ~PostMeshTracer()
+    {
+        if (!this->output.empty())
+            this->Write(this->output);
+    }
+
+    PostMeshTracer(const PostMeshTracer&) = delete;
+    PostMeshTracer& operator=(const PostMeshTracer&) = delete;
+
+    struct LocalLane
+    {
+        //! HOLDS THE BUFFER OF THE CALLING THREAD AND HANDS IT BACK ON EXIT
+        TraceBuffer *buffer = nullptr;
+        ~LocalLane()
+        {
+            if (this->buffer != nullptr)
+                PostMeshTracer::Instance().Release(this->buffer);
+        }
+    };
+
+    ALWAYS_INLINE TraceBuffer &LocalBuffer()
+    {
+        static thread_local LocalLane local;
+        if (local.buffer == nullptr)
+            local.buffer = this->Acquire();
+        return *local.buffer;
+    }
+
+    TraceBuffer *Acquire()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (!this->free_buffers.empty())
+        {
+            TraceBuffer *buffer = this->free_buffers.back();
+            this->free_buffers.pop_back();
+            return buffer;
+        }
+        this->buffers.emplace_back(new TraceBuffer(this->buffers.size()));
+        return this->buffers.back().get();
+    }
+
+    void Release(TraceBuffer *buffer)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->free_buffers.push_back(buffer);
+    }
+
+    std::atomic<bool> enabled;
+    std::atomic<Integer> epoch;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<TraceBuffer> > buffers;
+    std::vector<TraceBuffer*> free_buffers;
+    std::string output;
+};
+
+class PostMeshTraceScope
+{
+    //! RECORDS ITS LIFETIME AS ONE EVENT IF TRACING IS ENABLED
+public:
+    ALWAYS_INLINE PostMeshTraceScope(const char *name, const char *category, Integer lo=-1, Integer hi=-1) :
+        name(name), category(category), lo(lo), hi(hi),
+        start(PostMeshTracer::Enabled() ? PostMeshTracer::Instance().Begin() : -1) {}
+
+    ALWAYS_INLINE ~PostMeshTraceScope()
+    {
+        if (this->start >= 0 && PostMeshTracer::Enabled())
+            PostMeshTracer::Instance().Record(this->name,this->category,this->start,this->lo,this->hi);
+    }
+
+    PostMeshTraceScope(const PostMeshTraceScope&) = delete;
+    PostMeshTraceScope& operator=(const PostMeshTraceScope&) = delete;
+
+private:
+    const char *name;
+    const char *category;
+    Integer lo;
+    Integer hi;
+    Integer start;
+};
+
+ALWAYS_INLINE void StartTrace()
+{
+    PostMeshTracer::Instance().Start();
+}
+
+ALWAYS_INLINE void StopTrace()
+{
+    PostMeshTracer::Instance().Stop();
+}
+
+ALWAYS_INLINE bool WriteTrace(const char *filename)
+{
+    return PostMeshTracer::Instance().Write(filename);
+}
+
+#endif // POSTMESH_TRACE_HPP
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <array>
 #include <string>
 #include <sstream>
 #include <stdexcept>
@@ -21,6 +22,10 @@
 #include <limits>
 #include <chrono>
 #include <stdexcept>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 #ifdef WINDOWS
     #include <direct.h>
     #define GetCurrentDir _getcwd
@@ -36,6 +41,17 @@ typedef unsigned long long UInteger;
 typedef double Real;
 typedef bool Boolean;
 
+// INDEX TYPES OF THE CONNECTIVITY AND NODE BOOKKEEPING ARRAYS. BUILDING WITH
+// POSTMESH_INDEX32 STORES THEM IN 32 BITS, WHICH HALVES THEIR FOOTPRINT FOR
+// MESHES OF LESS THAN 2^31 NODES. COUNTS AND SIZES REMAIN Integer
+#ifdef POSTMESH_INDEX32
+typedef std::int32_t IndexI;
+typedef std::uint32_t IndexUI;
+#else
+typedef Integer IndexI;
+typedef UInteger IndexUI;
+#endif
+
 #define False false
 #define True  true
 
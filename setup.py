@@ -44,6 +44,12 @@ def setup_package():
                 _cxx_specified = True
                 _cxx_compiler = arg.split("=")[-1]
                 args.remove(arg)
+    # 32-bit connectivity indices: "python setup.py build_ext INDEX32=1"
+    _index32 = False
+    for arg in list(args):
+        if arg.startswith("INDEX32="):
+            _index32 = arg.split("=")[-1] == "1"
+            args.remove(arg)
     if _cxx_specified:
         os.environ["CC"] = _cxx_compiler
         os.environ["CXX"] = _cxx_compiler
@@ -56,11 +62,14 @@ def setup_package():
     # Compiler arguments
     if "clang++" in _cxx_compiler or ("c++" in _cxx_compiler and "darwin" in _os):
         compiler_args = ["-O3","-std=c++11","-m64","-march=native","-mtune=native","-ffp-contract=fast",
-                        "-ffast-math","-flto","-DNPY_NO_DEPRECATED_API","-Wno-shorten-64-to-32"]
+                        "-ffast-math","-flto","-pthread","-DNPY_NO_DEPRECATED_API","-Wno-shorten-64-to-32"]
     else:
         compiler_args = ["-O3","-std=c++11","-m64","-march=native","-mtune=native","-ffp-contract=fast",
                         "-mfpmath=sse","-ffast-math","-ftree-vectorize","-finline-functions","-finline-limit=100000",
-                        "-funroll-loops","-Wno-unused-function","-flto","-DNPY_NO_DEPRECATED_API","-Wno-cpp"]
+                        "-funroll-loops","-Wno-unused-function","-flto","-pthread","-DNPY_NO_DEPRECATED_API","-Wno-cpp"]
+
+    if _index32:
+        compiler_args.append("-DPOSTMESH_INDEX32")
 
     # if "darwin" in _os:
         # compiler_args.append("-stdlib=libstdc++")
@@ -141,7 +150,7 @@ def setup_package():
         license="MIT",
         install_requires=[
           'numpy>=1.9',
-          'cython>=0.23'],
+          'cython>=0.29.31'],
         packages=find_packages(),
         include_package_data=True,
         package_data={'': ['bindings/*','src/*','include/*','example/*',
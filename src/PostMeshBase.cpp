@@ -22,10 +22,24 @@ PostMeshBase::PostMeshBase(const PostMeshBase& other) \
     this->geometry_surfaces = other.geometry_surfaces;
     this->geometry_curves_types = other.geometry_curves_types;
     this->geometry_surfaces_types = other.geometry_surfaces_types;
+    this->geometry_surfaces_curves = other.geometry_surfaces_curves;
+    this->geometry_surfaces_curves_types = other.geometry_surfaces_curves_types;
+    this->topo_edges = other.topo_edges;
+    this->topo_faces = other.topo_faces;
+    this->parts_surfaces = other.parts_surfaces;
+    this->parts_curves = other.parts_curves;
+    this->surfaces_curves_materialised = other.surfaces_curves_materialised;
+    this->surfaces_adaptors = other.surfaces_adaptors;
     this->displacements_BC = other.displacements_BC;
-    this->index_nodes = other.index_nodes;
     this->nodes_dir = other.nodes_dir;
+    this->projection_residuals = other.projection_residuals;
     this->fekete = other.fekete;
+    this->binary_mesh = other.binary_mesh;
+    this->cad_cache_directory = other.cad_cache_directory;
+    this->cad_cache_key = other.cad_cache_key;
+    this->cad_cache = other.cad_cache;
+    this->stats = other.stats;
+    this->diagnostics = other.diagnostics;
 }
 
 PostMeshBase& PostMeshBase::operator=(const PostMeshBase& other) \
@@ -51,10 +65,24 @@ noexcept(std::is_copy_assignable<PostMeshBase>::value)
     this->geometry_surfaces = other.geometry_surfaces;
     this->geometry_curves_types = other.geometry_curves_types;
     this->geometry_surfaces_types = other.geometry_surfaces_types;
+    this->geometry_surfaces_curves = other.geometry_surfaces_curves;
+    this->geometry_surfaces_curves_types = other.geometry_surfaces_curves_types;
+    this->topo_edges = other.topo_edges;
+    this->topo_faces = other.topo_faces;
+    this->parts_surfaces = other.parts_surfaces;
+    this->parts_curves = other.parts_curves;
+    this->surfaces_curves_materialised = other.surfaces_curves_materialised;
+    this->surfaces_adaptors = other.surfaces_adaptors;
     this->displacements_BC = other.displacements_BC;
-    this->index_nodes = other.index_nodes;
     this->nodes_dir = other.nodes_dir;
+    this->projection_residuals = other.projection_residuals;
     this->fekete = other.fekete;
+    this->binary_mesh = other.binary_mesh;
+    this->cad_cache_directory = other.cad_cache_directory;
+    this->cad_cache_key = other.cad_cache_key;
+    this->cad_cache = other.cad_cache;
+    this->stats = other.stats;
+    this->diagnostics = other.diagnostics;
 
     return *this;
 }
@@ -79,10 +107,26 @@ PostMeshBase::PostMeshBase(PostMeshBase&& other) noexcept :  \
     this->geometry_surfaces = std::move(other.geometry_surfaces);
     this->geometry_curves_types = std::move(other.geometry_curves_types);
     this->geometry_surfaces_types = std::move(other.geometry_surfaces_types);
+    this->geometry_surfaces_curves = std::move(other.geometry_surfaces_curves);
+    this->geometry_surfaces_curves_types = std::move(other.geometry_surfaces_curves_types);
+    this->topo_edges = std::move(other.topo_edges);
+    this->topo_faces = std::move(other.topo_faces);
+    this->parts_surfaces = std::move(other.parts_surfaces);
+    this->parts_curves = std::move(other.parts_curves);
+    this->surfaces_curves_materialised = std::move(other.surfaces_curves_materialised);
+    this->surfaces_adaptors = std::move(other.surfaces_adaptors);
     this->displacements_BC = std::move(other.displacements_BC);
-    this->index_nodes = std::move(other.index_nodes);
     this->nodes_dir = std::move(other.nodes_dir);
+    this->projection_residuals = std::move(other.projection_residuals);
     this->fekete = std::move(other.fekete);
+    this->binary_mesh = std::move(other.binary_mesh);
+    this->cad_cache_directory = std::move(other.cad_cache_directory);
+    this->cad_cache_key = std::move(other.cad_cache_key);
+    this->cad_cache = std::move(other.cad_cache);
+    this->cad_cache_pending = std::move(other.cad_cache_pending);
+    other.cad_cache_pending.clear();
+    this->stats = std::move(other.stats);
+    this->diagnostics = std::move(other.diagnostics);
 
     //! NB: CHECK THAT YOUR VERSION OF EIGEN SUPPORTS RVALUE REFERENCES
     //! (EIGEN_HAVE_RVALUE_REFERENCES). In PostMesh this is activated by default.
@@ -93,6 +137,8 @@ PostMeshBase::PostMeshBase(PostMeshBase&& other) noexcept :  \
 PostMeshBase& PostMeshBase::operator=(PostMeshBase&& other) noexcept
 {
     // MOVE ASSIGNMENT OPERATOR
+    this->FlushCADCache();
+    this->InvalidateDirichletData();
     this->scale = other.scale;
     this->condition = other.condition;
     this->projection_precision = other.projection_precision;
@@ -112,10 +158,26 @@ PostMeshBase& PostMeshBase::operator=(PostMeshBase&& other) noexcept
     this->geometry_surfaces = std::move(other.geometry_surfaces);
     this->geometry_curves_types = std::move(other.geometry_curves_types);
     this->geometry_surfaces_types = std::move(other.geometry_surfaces_types);
+    this->geometry_surfaces_curves = std::move(other.geometry_surfaces_curves);
+    this->geometry_surfaces_curves_types = std::move(other.geometry_surfaces_curves_types);
+    this->topo_edges = std::move(other.topo_edges);
+    this->topo_faces = std::move(other.topo_faces);
+    this->parts_surfaces = std::move(other.parts_surfaces);
+    this->parts_curves = std::move(other.parts_curves);
+    this->surfaces_curves_materialised = std::move(other.surfaces_curves_materialised);
+    this->surfaces_adaptors = std::move(other.surfaces_adaptors);
     this->displacements_BC = std::move(other.displacements_BC);
-    this->index_nodes = std::move(other.index_nodes);
     this->nodes_dir = std::move(other.nodes_dir);
+    this->projection_residuals = std::move(other.projection_residuals);
     this->fekete = std::move(other.fekete);
+    this->binary_mesh = std::move(other.binary_mesh);
+    this->cad_cache_directory = std::move(other.cad_cache_directory);
+    this->cad_cache_key = std::move(other.cad_cache_key);
+    this->cad_cache = std::move(other.cad_cache);
+    this->cad_cache_pending = std::move(other.cad_cache_pending);
+    other.cad_cache_pending.clear();
+    this->stats = std::move(other.stats);
+    this->diagnostics = std::move(other.diagnostics);
 
     //! NB: CHECK THAT YOUR VERSION OF EIGEN SUPPORTS RVALUE REFERENCES
     //! (EIGEN_HAVE_RVALUE_REFERENCES). In PostMesh this is activated by default.
@@ -127,235 +189,684 @@ PostMeshBase& PostMeshBase::operator=(PostMeshBase&& other) noexcept
 
 
 
-void PostMeshBase::ReadIGES(const char* filename)
+// THE IGES/STEP TRANSLATORS SHARE PROCESS-GLOBAL STATE (Interface_Static, THE
+// PROTOCOL REGISTRIES, XSAlgo AND THE DEFAULT MESSENGER) THAT OCC DOES NOT
+// PROTECT, EVEN ACROSS READERS WITH SESSIONS OF THEIR OWN. EVERY ACCESS TO THEM
+// IS SERIALISED THROUGH THIS MUTEX
+static std::mutex cad_translation_mutex;
+PostMeshBase::~PostMeshBase()
 {
-    //! IGES FILE READER BASED ON OCC BACKEND
-    //! THIS FUNCTION CAN BE EXPANDED FURTHER TO TAKE CURVE/SURFACE CONSISTENY INTO ACCOUNT
-    //! http://www.opencascade.org/doc/occt-6.7.0/overview/html/user_guides__iges.html
+    this->FlushCADCache();
+}
 
-    IGESControl_Reader reader;
-    reader.ReadFile(filename);
-    // CHECK FOR IMPORT STATUS
-    reader.PrintCheckLoad(Standard_True,IFSelect_GeneralInfo);
-    reader.PrintCheckTransfer(Standard_True,IFSelect_ItemsByEntity);
-    // READ IGES FILE AS-IS
+
+static void ConfigureCADTranslation(const char *format)
+{
+    // READ IGES/STEP FILE AS-IS. THIS IS A GLOBAL SETTING OF THE TRANSLATORS
     Interface_Static::SetIVal("read.iges.bspline.continuity",0);
     Standard_Integer ic =  Interface_Static::IVal("read.iges.bspline.continuity");
     if (ic !=0)
     {
-        std::cerr << "IGES file was not read as-is. The file was not read/transformed correctly\n";
+        std::cerr << format << " file was not read as-is. The file was not read/transformed correctly\n";
     }
 
     // FORCE UNITS (NONE SEEM TO WORK)
     //Interface_Static::SetIVal("xstep.cascade.unit",0);
     //Interface_Static::SetIVal("read.scale.unit",0);
+}
+
+template<typename Reader>
+static TopoDS_Shape TranslateCADFile(const char *filename, const char *format, UInteger &no_of_shapes, bool serial=true)
+{
+    //! TRANSLATE AN IGES/STEP FILE WITH A READER (AND HENCE A SESSION) OF ITS OWN.
+    //! IF NOT serial, THE TRANSLATORS ARE EXPECTED TO BE CONFIGURED UP FRONT
+    //! (ConfigureCADTranslation) AND IMPORT STATUS IS NOT REPORTED. TRANSLATIONS
+    //! NEVER OVERLAP, SEE cad_translation_mutex
+    std::lock_guard<std::mutex> lock(cad_translation_mutex);
+    Reader reader;
+    reader.ReadFile(filename);
+    if (serial)
+    {
+        // CHECK FOR IMPORT STATUS
+        reader.PrintCheckLoad(Standard_True,IFSelect_GeneralInfo);
+        reader.PrintCheckTransfer(Standard_True,IFSelect_ItemsByEntity);
+        ConfigureCADTranslation(format);
+    }
 
     // IF ALL OKAY, THEN TRANSFER ROOTS
     reader.TransferRoots();
 
-    this->imported_shape  = reader.OneShape();
-    this->no_of_shapes = reader.NbShapes();
+    no_of_shapes = reader.NbShapes();
+    return reader.OneShape();
 }
 
-void PostMeshBase::ReadSTEP(const char* filename)
+void PostMeshBase::ReadIGES(const char* filename)
 {
+    PostMeshPhase phase(this->stats,"ReadIGES",&this->diagnostics);
     //! IGES FILE READER BASED ON OCC BACKEND
     //! THIS FUNCTION CAN BE EXPANDED FURTHER TO TAKE CURVE/SURFACE CONSISTENY INTO ACCOUNT
     //! http://www.opencascade.org/doc/occt-6.7.0/overview/html/user_guides__iges.html
 
-    STEPControl_Reader reader;
-    reader.ReadFile(filename);
-    // CHECK FOR IMPORT STATUS
-    reader.PrintCheckLoad(Standard_True,IFSelect_GeneralInfo);
-    reader.PrintCheckTransfer(Standard_True,IFSelect_ItemsByEntity);
-    // READ IGES FILE AS-IS
-    Interface_Static::SetIVal("read.iges.bspline.continuity",0);
-    Standard_Integer ic =  Interface_Static::IVal("read.iges.bspline.continuity");
-    if (ic !=0)
-    {
-        std::cerr << "STEP file was not read as-is. The file was not read/transformed correctly\n";
-    }
+    this->ResetGeometry();
+    if (this->ReadCADCache(filename))
+        return;
 
-    // FORCE UNITS (NONE SEEM TO WORK)
-    //Interface_Static::SetIVal("xstep.cascade.unit",0);
-    //Interface_Static::SetIVal("read.scale.unit",0);
+    this->imported_shape = TranslateCADFile<IGESControl_Reader>(filename,"IGES",this->no_of_shapes);
+    this->WriteCADCacheShape();
+}
 
-    // IF ALL OKAY, THEN TRANSFER ROOTS
-    reader.TransferRoots();
+void PostMeshBase::ReadSTEP(const char* filename)
+{
+    PostMeshPhase phase(this->stats,"ReadSTEP",&this->diagnostics);
+    //! STEP FILE READER BASED ON OCC BACKEND
+    //! THIS FUNCTION CAN BE EXPANDED FURTHER TO TAKE CURVE/SURFACE CONSISTENY INTO ACCOUNT
+    //! http://www.opencascade.org/doc/occt-6.7.0/overview/html/user_guides__iges.html
 
-    this->imported_shape  = reader.OneShape();
-    this->no_of_shapes = reader.NbShapes();
+    this->ResetGeometry();
+    if (this->ReadCADCache(filename))
+        return;
+
+    this->imported_shape = TranslateCADFile<STEPControl_Reader>(filename,"STEP",this->no_of_shapes);
+    this->WriteCADCacheShape();
 
     //auto edges = reader.GiveList("iges-faces");
 
 }
 
-Eigen::MatrixI PostMeshBase::Read(std::string &filename)
+void PostMeshBase::ReadCADFiles(const std::vector<std::string> &filenames)
 {
-    //! Reading 1D integer arrays
-    std::vector<std::string> arr;
-    arr.clear();
-    std::string temp;
-
-    std::ifstream datafile;
-    datafile.open(filename.c_str());
+    PostMeshPhase phase(this->stats,"ReadCADFiles");
+    //! READ AN ASSEMBLY GIVEN AS SEPARATE IGES/STEP/BREP PART FILES. BREP PARTS ARE
+    //! READ CONCURRENTLY, WHILE THE IGES/STEP TRANSLATORS ARE NOT THREAD-SAFE AND
+    //! TAKE TURNS, EACH WITH A READER SESSION OF ITS OWN. THE PARTS ARE MERGED INTO
+    //! A SINGLE COMPOUND IN THE ORDER GIVEN. THE SURFACES OF PART i ARE THEN
+    //! parts_surfaces[i] <= isurface < parts_surfaces[i+1], SIMILARLY FOR CURVES
+    this->ResetGeometry();
+
+    const Integer nparts = filenames.size();
+    std::vector<std::string> formats(nparts);
+    for (Integer i=0; i<nparts; ++i)
+    {
+        std::string suffix = filenames[i].substr(filenames[i].find_last_of('.')+1);
+        std::transform(suffix.begin(),suffix.end(),suffix.begin(),::tolower);
+        if (suffix=="iges" || suffix=="igs") formats[i] = "IGES";
+        else if (suffix=="step" || suffix=="stp") formats[i] = "STEP";
+        else if (suffix=="brep" || suffix=="brp") formats[i] = "BREP";
+        else throw std::invalid_argument("Unknown CAD file format: "+filenames[i]);
+    }
 
-    if(!datafile)
+    // INITIALISING THE TRANSLATORS AND SETTING THEIR PARAMETERS IS NOT THREAD-SAFE,
+    // SO BOTH ARE DONE HERE ONCE
+    std::unique_lock<std::mutex> lock(cad_translation_mutex);
+    if (std::count(formats.begin(),formats.end(),"IGES"))
     {
-        warn("Unable to read file");
+        IGESControl_Reader reader;
+        ConfigureCADTranslation("IGES");
     }
-    while(datafile)
+    if (std::count(formats.begin(),formats.end(),"STEP"))
     {
-        datafile >> temp;
-        temp += "";
-        arr.push_back(temp);
+        STEPControl_Reader reader;
+        ConfigureCADTranslation("STEP");
     }
+    lock.unlock();
 
-    datafile.close();
-
-    const Integer rows = arr.size();
-    const Integer cols = 1;
-
-    Eigen::MatrixI out_arr = Eigen::MatrixI::Zero(rows,cols);
-
-    for(Integer i=0 ; i<rows;i++)
+    std::vector<TopoDS_Shape> parts(nparts);
+    std::vector<UInteger> parts_no_of_shapes(nparts,1);
+    parallel_for(0,nparts,[&](Integer lo, Integer hi) {
+        for (Integer i=lo; i<hi; ++i)
+        {
+            const char *filename = filenames[i].c_str();
+            if (formats[i]=="IGES")
+            {
+                parts[i] = TranslateCADFile<IGESControl_Reader>(filename,"IGES",parts_no_of_shapes[i],false);
+            }
+            else if (formats[i]=="STEP")
+            {
+                parts[i] = TranslateCADFile<STEPControl_Reader>(filename,"STEP",parts_no_of_shapes[i],false);
+            }
+            else
+            {
+                BRep_Builder builder;
+                BRepTools::Read(parts[i],filename,builder);
+            }
+            if (parts[i].IsNull())
+            {
+                throw std::runtime_error("Unable to read CAD file "+filenames[i]);
+            }
+        }
+    });
+
+    TopoDS_Compound compound;
+    BRep_Builder builder;
+    builder.MakeCompound(compound);
+    this->parts_surfaces.assign(1,0);
+    this->parts_curves.assign(1,0);
+    this->no_of_shapes = 0;
+    for (Integer i=0; i<nparts; ++i)
     {
-        out_arr(i) = std::atof(arr[i].c_str());
+        builder.Add(compound,parts[i]);
+        Integer nsurfaces = 0, ncurves = 0;
+        for (TopExp_Explorer explorer(parts[i],TopAbs_FACE); explorer.More(); explorer.Next())
+            nsurfaces++;
+        for (TopExp_Explorer explorer(parts[i],TopAbs_EDGE); explorer.More(); explorer.Next())
+            ncurves++;
+        this->parts_surfaces.push_back(this->parts_surfaces.back()+nsurfaces);
+        this->parts_curves.push_back(this->parts_curves.back()+ncurves);
+        this->no_of_shapes += parts_no_of_shapes[i];
     }
+    this->imported_shape = compound;
+}
 
-    // CHECK IF LAST LINE IS READ CORRECTLY
-    if ( out_arr(out_arr.rows()-2)==out_arr(out_arr.rows()-1) )
+void PostMeshBase::ReadBREP(const char *filename)
+{
+    PostMeshPhase phase(this->stats,"ReadBREP");
+    //! READ A SHAPE IN THE NATIVE OCC BREP FORMAT. NO TRANSLATION IS INVOLVED
+    //! SO THIS IS MUCH FASTER THAN READING IGES/STEP FILES
+    TopoDS_Shape shape;
+    BRep_Builder builder;
+    if (!BRepTools::Read(shape,filename,builder) || shape.IsNull())
     {
-        out_arr = out_arr.block(0,0,out_arr.rows()-1,1).eval();
+        throw std::runtime_error(std::string("Unable to read BRep file ")+filename);
     }
+    this->SetShape(shape);
+}
 
-    return out_arr;
+void PostMeshBase::ReadBREPString(const std::string &brep)
+{
+    PostMeshPhase phase(this->stats,"ReadBREP");
+    //! READ A SHAPE FROM THE CONTENTS OF A BREP FILE HELD IN MEMORY, E.G.
+    //! AS WRITTEN BY BRepTools::Write TO A STREAM
+    TopoDS_Shape shape;
+    BRep_Builder builder;
+    std::istringstream stream(brep);
+    BRepTools::Read(shape,stream,builder);
+    if (shape.IsNull())
+    {
+        throw std::runtime_error("Unable to read BRep data");
+    }
+    this->SetShape(shape);
 }
 
-Eigen::MatrixUI PostMeshBase::ReadI(std::string &filename, char delim)
+void PostMeshBase::SetShape(const TopoDS_Shape &shape)
 {
-    /*Reading 2D integer row major arrays */
-    std::vector<std::string> arr;
-    arr.clear();
-    std::string temp;
+    //! USE A SHAPE THAT IS ALREADY IN MEMORY AS THE CAD MODEL, E.G. THE MODEL
+    //! HELD BY A MESH GENERATOR, INSTEAD OF READING IT FROM FILE. THE SHAPE IS
+    //! SHARED, NOT COPIED
+    this->ResetGeometry();
+    this->imported_shape = shape;
+    this->no_of_shapes = 1;
+}
 
-    std::ifstream datafile;
-    datafile.open(filename.c_str());
+void PostMeshBase::ResetGeometry()
+{
+    //! FORGET EVERYTHING DERIVED FROM A PREVIOUSLY IMPORTED SHAPE
+    this->FlushCADCache();
+    this->geometry_points.clear();
+    this->geometry_curves.clear();
+    this->geometry_surfaces.clear();
+    this->geometry_surfaces_curves.clear();
+    this->geometry_curves_types.clear();
+    this->geometry_surfaces_types.clear();
+    this->geometry_surfaces_curves_types.clear();
+    this->topo_edges.clear();
+    this->topo_faces.clear();
+    this->parts_surfaces.clear();
+    this->parts_curves.clear();
+    this->surfaces_curves_materialised.clear();
+    this->surfaces_adaptors.clear();
+    this->cad_cache_key.clear();
+    this->cad_cache.reset();
+}
 
-    if(!datafile)
+bool PostMeshBase::ReadCADCache(const char *filename)
+{
+    //! IF A CAD CACHE DIRECTORY IS SET, KEY THE CACHE BY THE CONTENTS OF THE
+    //! CAD FILE AND LOAD THE SHAPE FROM ITS NATIVE BREP COPY, IF ANY. THE
+    //! ARRAYS DERIVED FROM THE SHAPE ARE PICKED UP LATER FROM THE SIDECAR BY
+    //! THE FUNCTIONS COMPUTING THEM. RETURNS FALSE IF THE FILE NEEDS TO BE
+    //! TRANSLATED
+    this->cad_cache_key.clear();
+    this->cad_cache.reset();
+    if (this->cad_cache_directory.empty())
+        return false;
+
+    this->cad_cache_key = pio::FileKey(filename);
+    const std::string prefix = this->cad_cache_directory + "/" + this->cad_cache_key;
+    if (!std::ifstream((prefix+".brep").c_str()) || !std::ifstream((prefix+".pmcad").c_str()))
+        return false;
+
+    try
+    {
+        this->cad_cache = std::make_shared<pio::BinaryFile>(prefix+".pmcad");
+    }
+    catch (std::exception &e)
     {
-        warn("Unable to read file");
+        warn("Ignoring CAD cache",prefix,e.what());
+        return false;
     }
-    while(datafile)
+    const pio::ArrayRecord *no_of_shapes = this->FindCADCache("no_of_shapes",pio::DTYPE_UINT64,1,1);
+    TopoDS_Shape shape;
+    BRep_Builder builder;
+    if (no_of_shapes == nullptr || !BRepTools::Read(shape,(prefix+".brep").c_str(),builder))
     {
-        datafile >> temp;
-        temp += "";
-        arr.push_back(temp);
+        warn("Ignoring incomplete CAD cache",prefix);
+        this->cad_cache.reset();
+        return false;
     }
 
-    datafile.close();
+    this->imported_shape = shape;
+    this->no_of_shapes = this->cad_cache->View<UInteger>(*no_of_shapes)(0,0);
+    this->diagnostics.Report(SEVERITY_INFO,"Loaded CAD model from cache",prefix+".brep");
+    return true;
+}
 
+void PostMeshBase::WriteCADCacheShape()
+{
+    //! STORE A FRESHLY TRANSLATED SHAPE IN THE CAD CACHE AS NATIVE BREP
+    if (this->cad_cache_key.empty())
+        return;
 
-    const Integer rows = arr.size();
-    const Integer cols = (split(arr[0], delim)).size();
+    const std::string brep = this->cad_cache_directory + "/" + this->cad_cache_key + ".brep";
+    const std::string temporary = pio::TemporaryName(brep);
+    if (!BRepTools::Write(this->imported_shape,temporary.c_str()) ||
+        std::rename(temporary.c_str(),brep.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        warn("Could not write CAD cache",brep);
+        this->cad_cache_key.clear();
+        return;
+    }
+
+    Eigen::MatrixUI no_of_shapes = Eigen::MatrixUI::Constant(1,1,this->no_of_shapes);
+    this->UpdateCADCache({pio::MakeArrayDescriptor("no_of_shapes",no_of_shapes)});
+}
 
+const pio::ArrayRecord* PostMeshBase::FindCADCache(const char *name, std::uint32_t dtype, Integer rows, Integer cols)
+{
+    //! CACHED ARRAY OF THE CURRENT CAD MODEL, OR NULL IF IT IS NOT CACHED OR
+    //! DOES NOT HAVE THE EXPECTED DATA TYPE AND SHAPE (rows AND cols ARE ONLY
+    //! CHECKED IF NOT NEGATIVE)
+    if (!this->cad_cache)
+        return nullptr;
+    const pio::ArrayRecord *record = this->cad_cache->Find(name);
+    if (record == nullptr || record->dtype != dtype ||
+        (rows >= 0 && Integer(record->rows) != rows) || (cols >= 0 && Integer(record->cols) != cols))
+        return nullptr;
+    if (!this->cad_cache->Verify(*record))
+    {
+        warn("Checksum mismatch for cached CAD array",name);
+        return nullptr;
+    }
+    return record;
+}
 
-    Eigen::MatrixUI out_arr = Eigen::MatrixUI::Zero(rows,cols);
+void PostMeshBase::UpdateCADCache(const std::vector<pio::ArrayDescriptor> &arrays)
+{
+    //! ADD (OR REPLACE) ARRAYS IN THE SIDECAR OF THE CAD CACHE. THE ARRAYS ARE
+    //! COPIED AND KEPT UNTIL FlushCADCache, SO THE SIDECAR IS WRITTEN ONCE PER
+    //! MODEL RATHER THAN ONCE PER EXTRACTOR
+    if (this->cad_cache_key.empty())
+        return;
 
-    for(Integer i=0 ; i<rows;i++)
+    for (const auto &desc: arrays)
     {
-        std::vector<std::string> elems;
-        elems = split(arr[i], delim);
-        for(Integer j=0 ; j<cols;j++)
-        {
-            out_arr(i,j) = std::atof(elems[j].c_str());
-        }
+        const char *data = static_cast<const char*>(desc.data);
+        std::vector<char> bytes(data,data+desc.rows*desc.cols*desc.itemsize);
+        auto pending = std::find_if(this->cad_cache_pending.begin(),this->cad_cache_pending.end(),
+            [&desc](const std::pair<pio::ArrayDescriptor,std::vector<char>> &p) {return p.first.name==desc.name;});
+        if (pending != this->cad_cache_pending.end())
+            *pending = std::make_pair(desc,std::move(bytes));
+        else
+            this->cad_cache_pending.emplace_back(desc,std::move(bytes));
     }
+}
 
-    // CHECK IF LAST LINE IS READ CORRECTLY
-    bool duplicate_rows = False;
-    for (Integer j=0; j<cols; ++j)
+void PostMeshBase::FlushCADCache()
+{
+    //! MERGE THE PENDING ARRAYS WITH THOSE ALREADY IN THE SIDECAR. THE SIDECAR
+    //! IS WRITTEN TO A TEMPORARY FILE OF THIS PROCESS AND RENAMED, SO THAT A
+    //! MAPPING OF THE OLD SIDECAR AND OTHER PROCESSES WRITING OR READING IT
+    //! ARE NOT AFFECTED. FAILING TO WRITE THE CACHE IS NOT AN ERROR
+    if (this->cad_cache_pending.empty())
+        return;
+
+    std::string sidecar, temporary;
+    try
     {
-        if ( out_arr(out_arr.rows()-2,j)==out_arr(out_arr.rows()-1,j) )
+        sidecar = this->cad_cache_directory + "/" + this->cad_cache_key + ".pmcad";
+        temporary = pio::TemporaryName(sidecar);
+        std::vector<pio::ArrayDescriptor> merged;
+        for (const auto &pending: this->cad_cache_pending)
         {
-            duplicate_rows = True;
+            merged.push_back(pending.first);
+            merged.back().data = pending.second.data();
         }
-        else
+        const std::size_t npending = merged.size();
+        if (this->cad_cache)
         {
-            duplicate_rows = False;
+            for (Integer i=0; i<this->cad_cache->NbArrays(); ++i)
+            {
+                pio::ArrayDescriptor cached = this->cad_cache->Describe(this->cad_cache->Record(i));
+                auto replaced = std::find_if(merged.begin(),merged.begin()+npending,
+                    [&cached](const pio::ArrayDescriptor &desc) {return desc.name==cached.name;});
+                if (replaced == merged.begin()+npending)
+                    merged.push_back(cached);
+            }
         }
+
+        pio::WriteBinary(temporary,merged);
+    #ifdef WINDOWS
+        std::remove(sidecar.c_str());
+    #endif
+        if (std::rename(temporary.c_str(),sidecar.c_str()) != 0)
+            throw std::runtime_error("Unable to rename "+temporary);
+        this->cad_cache = std::make_shared<pio::BinaryFile>(sidecar);
     }
-    if (duplicate_rows == True)
+    catch (std::exception &e)
     {
-        out_arr = out_arr.block(0,0,out_arr.rows()-1,out_arr.cols()).eval();
+        if (!temporary.empty()) std::remove(temporary.c_str());
+        warn("Could not update CAD cache",sidecar,e.what());
     }
+    this->cad_cache_pending.clear();
+}
 
-    return out_arr;
+Eigen::MatrixI PostMeshBase::Read(std::string &filename)
+{
+    //! Reading 1D integer arrays. Every white space separated token
+    //! in the file becomes a row of the output column vector
+    return pio::ReadTokens<Integer>(filename,' ');
+}
+
+Eigen::MatrixIndexUI PostMeshBase::ReadI(std::string &filename, char delim)
+{
+    /*Reading 2D integer row major arrays */
+    return pio::ReadMatrix<IndexUI>(filename,delim);
 }
 
 Eigen::MatrixR PostMeshBase::ReadR(std::string &filename, char delim)
 {
     /*Reading 2D floating point row major arrays */
-    std::vector<std::string> arr;
-    arr.clear();
-    std::string temp;
+    return pio::ReadMatrix<Real>(filename,delim);
+}
+
+template<typename Key, typename Pack>
+static std::vector<Integer> UnsharedBoundaryEntities(Integer nentities, Pack pack)
+{
+    //! BUILD ONE KEY PER (ELEMENT, LOCAL FACE/EDGE) PAIR, RADIX SORT THEM AND
+    //! RETURN, IN ELEMENT ORDER, THE PAIRS WHOSE KEY OCCURS EXACTLY ONCE
+    std::vector<Key> keys(nentities);
+    parallel_for(0,nentities,[&](Integer lo, Integer hi) {
+        for (Integer i=lo; i<hi; ++i) keys[i] = pack(i);
+    }, 4096);
+
+    const std::vector<Integer> order = cnp::radix_argsort(keys);
+    std::vector<char> unshared(nentities,0);
+    for (Integer i=0; i<nentities;)
+    {
+        Integer j = i+1;
+        while (j<nentities && keys[order[j]]==keys[order[i]]) ++j;
+        if (j==i+1) unshared[order[i]] = 1;
+        i = j;
+    }
 
-    std::ifstream datafile;
-    datafile.open(filename.c_str());
+    std::vector<Integer> boundary;
+    for (Integer i=0; i<nentities; ++i)
+        if (unshared[i]) boundary.push_back(i);
+    return boundary;
+}
 
-    if(!datafile)
+static Eigen::MatrixIndexUI ExtractBoundary(const Eigen::Ref<const Eigen::MatrixIndexUI> &elements, const std::string &element_type)
+{
+    //! FACES (3D) OR EDGES (2D) OF A MESH THAT BELONG TO A SINGLE ELEMENT,
+    //! WITH THEIR HIGH ORDER NODES IN POSTMESH ORDERING. EVERY LOCAL FACE IS
+    //! KEYED BY ITS SORTED VERTEX NUMBERS PACKED INTO 64 BITS, OR 128 BITS
+    //! IF THE NODE NUMBERS ARE TOO WIDE
+    const Integer nelem = elements.rows();
+    if (nelem==0) return Eigen::MatrixIndexUI();
+    const Integer p = pio::InferElementDegree(element_type,elements.cols());
+    if (p < 1)
     {
-        warn("Unable to read file");
+        throw std::invalid_argument("Mesh connectivity does not correspond to complete Lagrange elements");
     }
-    while(datafile)
+    const std::vector<std::vector<Integer>> local_vertices = pio::ElementBoundaryVertices(element_type);
+    const std::vector<std::vector<Integer>> arrangement = pio::BoundaryNodeArrangement(element_type,p);
+    const Integer nlocal = local_vertices.size();
+    const Integer nverts = local_vertices[0].size();
+
+    Integer bits = 1;
+    while (bits<64 && (elements.maxCoeff() >> bits) != 0) ++bits;
+
+    auto sorted_vertices = [&](Integer i, std::array<std::uint64_t,4> &verts) {
+        const std::vector<Integer> &local = local_vertices[i % nlocal];
+        for (Integer k=0; k<nverts; ++k) verts[k] = elements(i / nlocal,local[k]);
+        std::sort(verts.begin(),verts.begin()+nverts);
+    };
+
+    std::vector<Integer> boundary;
+    if (nverts*bits <= 64)
     {
-        datafile >> temp;
-        temp += "";
-        arr.push_back(temp);
+        boundary = UnsharedBoundaryEntities<std::uint64_t>(nelem*nlocal,[&](Integer i) {
+            std::array<std::uint64_t,4> verts;
+            sorted_vertices(i,verts);
+            std::uint64_t key = 0;
+            for (Integer k=0; k<nverts; ++k) key = (key << bits) | verts[k];
+            return key;
+        });
+    }
+    else if (bits <= 32)
+    {
+        boundary = UnsharedBoundaryEntities<cnp::uint128_key>(nelem*nlocal,[&](Integer i) {
+            std::array<std::uint64_t,4> verts;
+            sorted_vertices(i,verts);
+            cnp::uint128_key key = {0,0};
+            for (Integer k=0; k<nverts/2; ++k) key.hi = (key.hi << bits) | verts[k];
+            for (Integer k=nverts/2; k<nverts; ++k) key.lo = (key.lo << bits) | verts[k];
+            return key;
+        });
+    }
+    else
+    {
+        throw std::overflow_error("Node numbers are too large to extract the boundary of the mesh");
     }
 
-    datafile.close();
-
-
-    const Integer rows = arr.size();
-    const Integer cols = (split(arr[0], delim)).size();
+    Eigen::MatrixIndexUI entities(boundary.size(),arrangement[0].size());
+    parallel_for(0,entities.rows(),[&](Integer lo, Integer hi) {
+        for (Integer r=lo; r<hi; ++r)
+        {
+            const std::vector<Integer> &local = arrangement[boundary[r] % nlocal];
+            for (Integer k=0; k<entities.cols(); ++k)
+                entities(r,k) = elements(boundary[r] / nlocal,local[k]);
+        }
+    }, 4096);
+    return entities;
+}
 
+void PostMeshBase::ReadGmsh(const char *filename)
+{
+    PostMeshPhase phase(this->stats,"ReadGmsh");
+    //! SET UP THE MESH FROM A GMSH MSH 4.1 FILE (ASCII OR BINARY). ELEMENT
+    //! TYPE AND DIMENSION ARE TAKEN FROM THE FILE AND HIGH ORDER NODES ARE
+    //! RE-ORDERED FROM GMSH TO POSTMESH ORDERING. BOUNDARY FACES (3D) AND
+    //! EDGES ARE TAKEN FROM THE SURFACE AND LINE ELEMENTS OF THE FILE
+    pio::GmshMesh mesh = pio::ReadGmsh(filename);
+
+    if (!this->mesh_element_type.empty() && this->mesh_element_type != mesh.element_type)
+    {
+        warn("Element type of PostMesh object changed from",this->mesh_element_type,"to",mesh.element_type);
+    }
+    this->mesh_element_type = mesh.element_type;
+    this->ndim = mesh.ndim;
+    this->mesh_elements = std::move(mesh.elements);
+    this->mesh_points = std::move(mesh.points);
+    this->mesh_faces = std::move(mesh.faces);
+    this->mesh_edges = std::move(mesh.edges);
+
+    // DERIVE THE BOUNDARY IF THE FILE DOES NOT CARRY ONE
+    if (this->ndim==3 && this->mesh_faces.rows()==0)
+    {
+        this->ExtractBoundaryFaces();
+    }
+    else if (this->ndim==2 && this->mesh_edges.rows()==0)
+    {
+        this->ExtractBoundaryEdges();
+    }
+}
 
-    Eigen::MatrixR out_arr = Eigen::MatrixR::Zero(rows,cols);
+void PostMeshBase::ExtractBoundaryFaces()
+{
+    //! DERIVE mesh_faces FROM mesh_elements FOR TETRAHEDRAL AND HEXAHEDRAL
+    //! MESHES. FACES ARE ORIENTED OUTWARD AND LISTED IN ELEMENT ORDER
+    if (this->mesh_element_type!="tet" && this->mesh_element_type!="hex")
+    {
+        warn("Boundary faces can only be extracted from tet or hex meshes");
+        return;
+    }
+    this->mesh_faces = ExtractBoundary(this->mesh_elements,this->mesh_element_type);
+}
 
-    for(Integer i=0 ; i<rows;i++)
+void PostMeshBase::ExtractBoundaryEdges()
+{
+    //! DERIVE mesh_edges FROM mesh_elements FOR TRIANGULAR AND QUADRILATERAL
+    //! MESHES. EDGES ARE ORIENTED COUNTER-CLOCKWISE AND LISTED IN ELEMENT ORDER
+    if (this->mesh_element_type!="tri" && this->mesh_element_type!="quad")
     {
-        std::vector<std::string> elems;
-        elems = split(arr[i], delim);
-        for(Integer j=0 ; j<cols;j++)
-        {
-            out_arr(i,j) = std::atof(elems[j].c_str());
-        }
+        warn("Boundary edges can only be extracted from tri or quad meshes");
+        return;
     }
+    this->mesh_edges = ExtractBoundary(this->mesh_elements,this->mesh_element_type);
+}
 
-    // CHECK IF LAST LINE IS READ CORRECTLY
-    bool duplicate_rows = False;
-    for (Integer j=0; j<cols; ++j)
+template<typename T>
+struct MappedArray
+{
+    //! AN ARRAY OF A BINARY CONTAINER READY TO BE HANDED TO A SETTER, EITHER
+    //! IN PLACE IN THE MAPPING OR CONVERTED INTO OWNED STORAGE
+    T *data = nullptr;
+    Integer rows = 0;
+    Integer cols = 0;
+    bool borrow = true;
+    Eigen::Matrix<T,DYNAMIC,DYNAMIC,POSTMESH_ALIGNED> converted;
+};
+
+template<typename T>
+static void PrepareMappedArray(pio::BinaryFile &binfile, const pio::ArrayRecord *record, bool convert, MappedArray<T> &arr)
+{
+    //! CONNECTIVITY STORED WITH ANOTHER INDEX WIDTH THAN THAT OF THIS BUILD
+    //! IS CONVERTED INTO OWNED STORAGE INSTEAD OF BORROWED
+    if (record == nullptr)
+        return;
+    if (convert && record->dtype != pio::dtype_of<T>::value)
     {
-        if ( out_arr(out_arr.rows()-2,j)==out_arr(out_arr.rows()-1,j) )
-        {
-            duplicate_rows = True;
-        }
-        else
+        arr.converted = binfile.Convert<T>(*record);
+        arr.data = arr.converted.data();
+        arr.borrow = false;
+    }
+    else
+    {
+        auto view = binfile.View<T>(*record);
+        arr.data = view.data();
+    }
+    arr.rows = record->rows;
+    arr.cols = record->cols;
+}
+
+template<typename T>
+static void ReleaseMapping(const pio::BinaryFile &mapping, Eigen::BorrowableMatrix<T> &arr)
+{
+    //! COPY AN ARRAY BORROWED FROM mapping INTO OWNED STORAGE
+    if (arr.IsBorrowed() && mapping.Contains(arr.data()))
+        arr.MakeWritable();
+}
+
+void PostMeshBase::ReadMeshBinary(const char *filename, bool verify)
+{
+    PostMeshPhase phase(this->stats,"ReadMeshBinary");
+    //! LOAD THE MESH FROM A BINARY CONTAINER WRITTEN BY WriteMeshBinary (OR
+    //! ITS PYTHON COUNTERPART). THE FILE IS MAPPED AND ITS ARRAYS ARE HANDED
+    //! TO THE SetMesh* SETTERS AS IS, WITHOUT ANY PARSING. THE MESH ARRAYS
+    //! BORROW THE MAPPING, WHICH IS KEPT ALIVE BY THIS OBJECT (AND ITS COPIES).
+    //! ARRAYS THAT ARE NOT PRESENT IN THE CONTAINER ARE LEFT UNTOUCHED
+    std::shared_ptr<pio::BinaryFile> mapping = std::make_shared<pio::BinaryFile>(filename);
+    pio::BinaryFile &binfile = *mapping;
+
+    auto find = [&](const char *name) -> const pio::ArrayRecord* {
+        const pio::ArrayRecord *record = binfile.Find(name);
+        if (record != nullptr && verify && !binfile.Verify(*record))
         {
-            duplicate_rows = False;
+            throw std::runtime_error(std::string("Checksum mismatch for array ")+name+" in "+filename);
         }
-    }
-    if (duplicate_rows == True)
+        return record;
+    };
+
+    // EVERY ARRAY IS LOOKED UP, VERIFIED AND TYPE CHECKED BEFORE THE FIRST
+    // ONE IS SET, SO THAT A BAD CONTAINER LEAVES THE MESH AS IT WAS
+    MappedArray<IndexUI> elements, edges, faces;
+    MappedArray<Real> points, nodal_spacing;
+    MappedArray<UInteger> projection_criteria;
+    PrepareMappedArray(binfile,find("elements"),true,elements);
+    PrepareMappedArray(binfile,find("points"),false,points);
+    PrepareMappedArray(binfile,find("edges"),true,edges);
+    PrepareMappedArray(binfile,find("faces"),true,faces);
+    PrepareMappedArray(binfile,find("nodal_spacing"),false,nodal_spacing);
+    PrepareMappedArray(binfile,find("projection_criteria"),false,projection_criteria);
+
+    // THE NEW MAPPING IS OWNED BEFORE ANYTHING BORROWS IT
+    std::shared_ptr<pio::BinaryFile> previous = std::move(this->binary_mesh);
+    this->binary_mesh = mapping;
+
+    if (elements.data != nullptr)
+        this->SetMeshElements(elements.data,elements.rows,elements.cols,elements.borrow);
+    if (points.data != nullptr)
+        this->SetMeshPoints(points.data,points.rows,points.cols,true);
+    if (edges.data != nullptr)
+        this->SetMeshEdges(edges.data,edges.rows,edges.cols,edges.borrow);
+    if (faces.data != nullptr)
+        this->SetMeshFaces(faces.data,faces.rows,faces.cols,faces.borrow);
+    if (nodal_spacing.data != nullptr)
+        this->SetNodalSpacing(nodal_spacing.data,nodal_spacing.rows,nodal_spacing.cols,true);
+    if (projection_criteria.data != nullptr)
+        this->SetProjectionCriteria(projection_criteria.data,projection_criteria.rows,projection_criteria.cols);
+
+    // ARRAYS LEFT UNTOUCHED MAY STILL BORROW A PREVIOUSLY LOADED CONTAINER,
+    // WHICH IS RELEASED HERE, SO THEY ARE COPIED OUT OF IT FIRST
+    if (previous)
     {
-        out_arr = out_arr.block(0,0,out_arr.rows()-1,out_arr.cols()).eval();
+        ReleaseMapping(*previous,this->mesh_elements);
+        ReleaseMapping(*previous,this->mesh_points);
+        ReleaseMapping(*previous,this->mesh_edges);
+        ReleaseMapping(*previous,this->mesh_faces);
+        ReleaseMapping(*previous,this->fekete);
     }
+}
 
-    return out_arr;
+void PostMeshBase::WriteMeshBinary(const char *filename)
+{
+    //! WRITE THE MESH TO A BINARY CONTAINER. MESH POINTS ARE WRITTEN IN
+    //! THE UNITS THEY WERE SUPPLIED IN, I.E. BEFORE SCALING
+    std::vector<pio::ArrayDescriptor> arrays;
+    if (this->mesh_elements.size())
+        arrays.push_back(pio::MakeArrayDescriptor("elements",this->mesh_elements));
+    Eigen::MatrixR unscaled_points;
+    if (this->mesh_points.size())
+    {
+        unscaled_points = this->mesh_points/this->scale;
+        arrays.push_back(pio::MakeArrayDescriptor("points",unscaled_points));
+    }
+    if (this->mesh_edges.size())
+        arrays.push_back(pio::MakeArrayDescriptor("edges",this->mesh_edges));
+    if (this->mesh_faces.size())
+        arrays.push_back(pio::MakeArrayDescriptor("faces",this->mesh_faces));
+    if (this->fekete.size())
+        arrays.push_back(pio::MakeArrayDescriptor("nodal_spacing",this->fekete));
+    if (this->projection_criteria.size())
+        arrays.push_back(pio::MakeArrayDescriptor("projection_criteria",this->projection_criteria));
+
+    pio::WriteBinary(filename,arrays);
 }
 
 void PostMeshBase::CheckMesh()
 {
+    PostMeshPhase phase(this->stats,"CheckMesh");
     /* CHECKS IF MESH IS IMPORTED CORRECTLY */
 
     // CHECK FOR DUPLICATED LINE COPIES IN ELEMENTS, POINTS, EDGES AND FACES
@@ -371,9 +882,7 @@ void PostMeshBase::CheckMesh()
     }
     if (flag_p == 1)
     {
-        Eigen::MatrixI a_rows = cnp::arange(Integer(this->mesh_points.rows()-1));
-        Eigen::MatrixI a_cols = cnp::arange(Integer(this->mesh_points.cols()));
-        this->mesh_points = cnp::take(this->mesh_points,a_rows,a_cols);
+        this->mesh_points.TruncateRows(this->mesh_points.rows()-1);
     }
 
     // ELEMENTS
@@ -388,9 +897,7 @@ void PostMeshBase::CheckMesh()
     }
     if (flag_e == 1)
     {
-        Eigen::MatrixI a_rows = cnp::arange(Integer(this->mesh_elements.rows()-1));
-        Eigen::MatrixI a_cols = cnp::arange(Integer(this->mesh_elements.cols()));
-        this->mesh_elements = cnp::take(this->mesh_elements,a_rows,a_cols);
+        this->mesh_elements.TruncateRows(this->mesh_elements.rows()-1);
     }
 
     // EDGES
@@ -405,9 +912,7 @@ void PostMeshBase::CheckMesh()
     }
     if (flag_ed == 1)
     {
-        Eigen::MatrixI a_rows = cnp::arange(Integer(this->mesh_edges.rows()-1));
-        Eigen::MatrixI a_cols = cnp::arange(Integer(this->mesh_edges.cols()));
-        this->mesh_edges = cnp::take(this->mesh_edges,a_rows,a_cols);
+        this->mesh_edges.TruncateRows(this->mesh_edges.rows()-1);
     }
 
     // FACES FOR 3D
@@ -424,9 +929,7 @@ void PostMeshBase::CheckMesh()
         }
         if (flag_f == 1)
         {
-            Eigen::MatrixI a_rows = cnp::arange(Integer(this->mesh_faces.rows()-1));
-            Eigen::MatrixI a_cols = cnp::arange(Integer(this->mesh_faces.cols()));
-            this->mesh_faces = cnp::take(this->mesh_faces,a_rows,a_cols);
+            this->mesh_faces.TruncateRows(this->mesh_faces.rows()-1);
         }
     }
 
@@ -445,9 +948,21 @@ void PostMeshBase::CheckMesh()
 
 void PostMeshBase::GetGeomVertices()
 {
+    PostMeshPhase phase(this->stats,"GetGeomVertices");
     if (!this->geometry_points.empty())
         return;
 
+    const pio::ArrayRecord *cached = this->FindCADCache("geometry_points",pio::DTYPE_FLOAT64,-1,3);
+    if (cached != nullptr)
+    {
+        auto points = this->cad_cache->View<Real>(*cached);
+        for (Integer i=0; i<points.rows(); ++i)
+        {
+            this->geometry_points.push_back(gp_Pnt(points(i,0),points(i,1),points(i,2)));
+        }
+        return;
+    }
+
     for (TopExp_Explorer explorer(this->imported_shape,TopAbs_VERTEX); explorer.More(); explorer.Next())
     {
         // GET THE VERTICES LYING ON THE IMPORTED TOPOLOGICAL SHAPE
@@ -456,87 +971,235 @@ void PostMeshBase::GetGeomVertices()
 
         this->geometry_points.push_back(current_vertex_point);
     }
+
+    if (!this->cad_cache_key.empty())
+    {
+        std::vector<Real> points = this->ObtainGeomVertices();
+        this->UpdateCADCache({pio::MakeArrayDescriptor("geometry_points",
+            Eigen::Map<Eigen::MatrixR>(points.data(),this->geometry_points.size(),3))});
+    }
+}
+
+void PostMeshBase::IndexGeometry()
+{
+    //! INDEX THE TOPOLOGICAL EDGES AND FACES OF THE IMPORTED SHAPE. THE ORDER
+    //! OF EXPLORATION DEFINES THE CURVE AND SURFACE IDS. THIS IS ALL THAT IS
+    //! DONE FOR EVERY ENTITY UP FRONT, THEIR TYPES, ADAPTORS AND CURVE LISTS
+    //! ARE MATERIALISED ON FIRST USE BY THE ACCESSORS BELOW
+    if (this->topo_edges.empty())
+    {
+        for (TopExp_Explorer explorer(this->imported_shape,TopAbs_EDGE); explorer.More(); explorer.Next())
+        {
+            this->topo_edges.push_back(TopoDS::Edge(explorer.Current()));
+        }
+    }
+    if (this->topo_faces.empty())
+    {
+        for (TopExp_Explorer explorer(this->imported_shape,TopAbs_FACE); explorer.More(); explorer.Next())
+        {
+            this->topo_faces.push_back(TopoDS::Face(explorer.Current()));
+        }
+    }
 }
 
 void PostMeshBase::GetGeomEdges()
 {
+    PostMeshPhase phase(this->stats,"GetGeomEdges");
     //!  ITERATE OVER TopoDS_Shape AND EXTRACT ALL THE EDGES. CONVERT THE EDGES TO Geom_Curve AND
-    //! GET THEIR HANDLES
+    //! GET THEIR HANDLES. THE TYPES OF THE CURVES AND THE CURVES OF EVERY SURFACE ARE
+    //! ONLY SET UP HERE, SEE CurveType AND SurfaceCurves
 
     if (!this->geometry_curves.empty())
         return;
 
-    for (TopExp_Explorer explorer(this->imported_shape,TopAbs_EDGE); explorer.More(); explorer.Next())
+    this->IndexGeometry();
+    for (auto &current_edge: this->topo_edges)
     {
-        // GET THE EDGES
-        TopoDS_Edge current_edge = TopoDS::Edge(explorer.Current());
         // CONVERT THEM TO GEOM_CURVE
         Real first, last;
         Handle_Geom_Curve curve = BRep_Tool::Curve(current_edge,first,last);
         // STORE HANDLE IN THE CONTAINER
         this->geometry_curves.push_back(curve);
-
-        // TO GET TYPE OF THE CURVE - UNLIKE GeomAdaptor_Curve, BRepAdaptor_Curve
-        // DOES NOT THROW BUT RETURNS GeomAbs_OtherCurve FOR UNKNOWN TYPE OF CURVES
-        BRepAdaptor_Curve adapt_curve(current_edge);
-        // STORE TYPE OF CURVE (CURVE TYPES ARE DEFINED IN OCC_INC.hpp)
-        this->geometry_curves_types.push_back(adapt_curve.GetType());
     }
 
+    const UInteger nsurfaces = this->topo_faces.size();
+    this->geometry_curves_types.assign(this->topo_edges.size(),POSTMESH_LAZY_TYPE);
+    this->geometry_surfaces_curves.assign(nsurfaces,std::vector<Handle_Geom_Curve>());
+    this->geometry_surfaces_curves_types.assign(nsurfaces,std::vector<UInteger>());
+    this->surfaces_curves_materialised.assign(nsurfaces,false);
+
+    // CURVE TYPES OF A CACHED CAD MODEL DO NOT NEED TO BE RECOMPUTED
+    const pio::ArrayRecord *cached_types = this->FindCADCache("curve_types",pio::DTYPE_UINT64,this->topo_edges.size(),1);
+    const pio::ArrayRecord *cached_surface_types = this->FindCADCache("surface_curve_types",pio::DTYPE_UINT64,-1,1);
+    const pio::ArrayRecord *cached_surface_offsets = this->FindCADCache("surface_curve_offsets",pio::DTYPE_UINT64,nsurfaces+1,1);
+    if (cached_types != nullptr)
+    {
+        auto types = this->cad_cache->View<UInteger>(*cached_types);
+        this->geometry_curves_types.assign(types.data(),types.data()+types.rows());
+    }
+    if (cached_surface_types != nullptr && cached_surface_offsets != nullptr)
+    {
+        auto types = this->cad_cache->View<UInteger>(*cached_surface_types);
+        auto offsets = this->cad_cache->View<UInteger>(*cached_surface_offsets);
+        if (pio::ValidOffsets(offsets.data(),offsets.rows(),types.rows()))
+        {
+            for (UInteger isurface=0; isurface<nsurfaces; ++isurface)
+            {
+                this->geometry_surfaces_curves_types[isurface].assign(types.data()+offsets(isurface),types.data()+offsets(isurface+1));
+            }
+        }
+        else
+        {
+            warn("Ignoring invalid cached CAD array","surface_curve_offsets");
+            cached_surface_types = nullptr;
+        }
+    }
 
-    // DETERMINE WHICH CURVES SET ON WHICH SURFACES
-    for (TopExp_Explorer explorer(this->imported_shape,TopAbs_FACE); explorer.More(); explorer.Next())
+    // A CAD MODEL THAT IS BEING CACHED IS MATERIALISED IN FULL ONCE, SO THAT
+    // LATER RUNS FIND ALL OF IT IN THE CACHE
+    if (!this->cad_cache_key.empty() && (cached_types == nullptr || cached_surface_types == nullptr))
     {
-        std::vector<Handle_Geom_Curve> current_surface_curves;
-        std::vector<UInteger> current_surface_curves_types;
-        for (TopExp_Explorer explorer_edge(explorer.Current(),TopAbs_EDGE); explorer_edge.More(); explorer_edge.Next())
+        std::vector<UInteger> surface_curves_types, surface_curves_offsets(1,0);
+        for (UInteger icurve=0; icurve<this->topo_edges.size(); ++icurve)
+        {
+            this->CurveType(icurve);
+        }
+        for (UInteger isurface=0; isurface<nsurfaces; ++isurface)
         {
-            // GET THE EDGES
-            TopoDS_Edge current_edge = TopoDS::Edge(explorer_edge.Current());
-            // CONVERT THEM TO GEOM_CURVE
-            Real first, last;
-            Handle_Geom_Curve curve = BRep_Tool::Curve(current_edge,first,last);
-            // STORE HANDLE IN THE CONTAINER
-            current_surface_curves.push_back(curve);
-
-            // TO GET TYPE OF THE CURVE - UNLIKE GeomAdaptor_Curve, BRepAdaptor_Curve
-            // DOES NOT THROW BUT RETURNS GeomAbs_OtherCurve FOR UNKNOWN TYPE OF CURVES
-            BRepAdaptor_Curve adapt_curve(current_edge);
-            // STORE TYPE OF CURVE (CURVE TYPES ARE DEFINED IN OCC_INC.hpp)
-            current_surface_curves_types.push_back(adapt_curve.GetType());
+            const std::vector<UInteger> &types = this->SurfaceCurvesTypes(isurface);
+            surface_curves_types.insert(surface_curves_types.end(),types.begin(),types.end());
+            surface_curves_offsets.push_back(surface_curves_types.size());
         }
-        this->geometry_surfaces_curves.push_back(current_surface_curves);
-        this->geometry_surfaces_curves_types.push_back(current_surface_curves_types);
+        this->UpdateCADCache({
+            pio::MakeArrayDescriptor("curve_types",Eigen::Map<Eigen::MatrixUI>(this->geometry_curves_types.data(),this->geometry_curves_types.size(),1)),
+            pio::MakeArrayDescriptor("surface_curve_types",Eigen::Map<Eigen::MatrixUI>(surface_curves_types.data(),surface_curves_types.size(),1)),
+            pio::MakeArrayDescriptor("surface_curve_offsets",Eigen::Map<Eigen::MatrixUI>(surface_curves_offsets.data(),surface_curves_offsets.size(),1))});
     }
 }
 
 void PostMeshBase::GetGeomFaces()
 {
+    PostMeshPhase phase(this->stats,"GetGeomFaces");
     //!  ITERATE OVER TopoDS_Shape AND EXTRACT ALL THE EDGES. CONVERT THE EDGES TO Geom_Surface AND
-    //! GET THEIR HANDLES
+    //! GET THEIR HANDLES. THE TYPES AND ADAPTORS OF THE SURFACES ARE ONLY SET UP HERE,
+    //! SEE SurfaceType AND SurfaceAdaptor
 
-    if (!this->geometry_surfaces.empty() && !this->topo_faces.empty())
+    if (!this->geometry_surfaces.empty())
         return;
 
-    for (TopExp_Explorer explorer(this->imported_shape,TopAbs_FACE); explorer.More(); explorer.Next())
+    this->IndexGeometry();
+    for (auto &current_face: this->topo_faces)
     {
-
-        // GET THE FACES
-        TopoDS_Face current_face = TopoDS::Face(explorer.Current());
-        // STORE
-        this->topo_faces.push_back(current_face);
         // CONVERT THEM TO GEOM_SURFACE
         Handle_Geom_Surface surface = BRep_Tool::Surface(current_face);
         // STORE HANDLE IN THE CONTAINER
         this->geometry_surfaces.push_back(surface);
+    }
+
+    this->geometry_surfaces_types.assign(this->topo_faces.size(),POSTMESH_LAZY_TYPE);
+    this->surfaces_adaptors.assign(this->topo_faces.size(),nullptr);
+
+    // SURFACE TYPES OF A CACHED CAD MODEL DO NOT NEED TO BE RECOMPUTED
+    const pio::ArrayRecord *cached_types = this->FindCADCache("surface_types",pio::DTYPE_UINT64,this->topo_faces.size(),1);
+    if (cached_types != nullptr)
+    {
+        auto types = this->cad_cache->View<UInteger>(*cached_types);
+        this->geometry_surfaces_types.assign(types.data(),types.data()+types.rows());
+    }
+    else if (!this->cad_cache_key.empty())
+    {
+        for (UInteger isurface=0; isurface<this->topo_faces.size(); ++isurface)
+        {
+            this->SurfaceType(isurface);
+        }
+        this->UpdateCADCache({pio::MakeArrayDescriptor("surface_types",Eigen::Map<Eigen::MatrixUI>(this->geometry_surfaces_types.data(),this->geometry_surfaces_types.size(),1))});
+    }
+}
+
+UInteger PostMeshBase::CurveType(UInteger icurve)
+{
+    //! TYPE OF A CURVE (CURVE TYPES ARE DEFINED IN OCC_INC.hpp), DETERMINED ON FIRST USE
+    UInteger &type = this->geometry_curves_types[icurve];
+    if (type == POSTMESH_LAZY_TYPE)
+    {
+        // UNLIKE GeomAdaptor_Curve, BRepAdaptor_Curve DOES NOT THROW BUT RETURNS
+        // GeomAbs_OtherCurve FOR UNKNOWN TYPE OF CURVES
+        type = BRepAdaptor_Curve(this->topo_edges[icurve]).GetType();
+    }
+    return type;
+}
+
+UInteger PostMeshBase::SurfaceType(UInteger isurface)
+{
+    //! TYPE OF A SURFACE (SURFACE TYPES ARE DEFINED IN OCC_INC.hpp), DETERMINED ON FIRST USE
+    UInteger &type = this->geometry_surfaces_types[isurface];
+    if (type == POSTMESH_LAZY_TYPE)
+    {
+        type = this->SurfaceAdaptor(isurface).GetType();
+    }
+    return type;
+}
+
+const BRepAdaptor_Surface& PostMeshBase::SurfaceAdaptor(UInteger isurface)
+{
+    //! ADAPTOR OF A TOPOLOGICAL FACE, BUILT ON FIRST USE AND SHARED BY ALL
+    //! SUBSEQUENT QUERIES ON THE SURFACE. UNLIKE GeomAdaptor_Surface,
+    //! BRepAdaptor_Surface DOES NOT THROW BUT RETURNS GeomAbs_OtherSurface
+    //! FOR UNKNOWN TYPE OF SURFACES
+    std::shared_ptr<BRepAdaptor_Surface> &adaptor = this->surfaces_adaptors[isurface];
+    if (!adaptor)
+    {
+        adaptor = std::make_shared<BRepAdaptor_Surface>(this->topo_faces[isurface]);
+    }
+    return *adaptor;
+}
+
+const std::vector<Handle_Geom_Curve>& PostMeshBase::SurfaceCurves(UInteger isurface)
+{
+    //! CURVES BOUNDING A SURFACE, EXTRACTED ON FIRST USE
+    this->MaterialiseSurfaceCurves(isurface);
+    return this->geometry_surfaces_curves[isurface];
+}
+
+const std::vector<UInteger>& PostMeshBase::SurfaceCurvesTypes(UInteger isurface)
+{
+    //! TYPES OF THE CURVES BOUNDING A SURFACE, DETERMINED ON FIRST USE
+    this->MaterialiseSurfaceCurves(isurface);
+    return this->geometry_surfaces_curves_types[isurface];
+}
+
+void PostMeshBase::MaterialiseSurfaceCurves(UInteger isurface)
+{
+    //! DETERMINE WHICH CURVES SET ON A SURFACE
+    if (this->surfaces_curves_materialised[isurface])
+        return;
 
-        // TO GET TYPE OF THE SURFACE. UNLIKE GeomAdaptor_Surface, BRepAdaptor_Surface
-        // DOES NOT THROW BUT RETURNS GeomAbs_OtherSurface FOR UNKNOWN TYPE OF SURFACES
-        BRepAdaptor_Surface adapt_surface(current_face);
-        // STORE TYPE OF SURFACE (SURFACE TYPES ARE DEFINED IN OCC_INC.hpp)
-        this->geometry_surfaces_types.push_back(adapt_surface.GetType());
+    std::vector<Handle_Geom_Curve> &current_surface_curves = this->geometry_surfaces_curves[isurface];
+    std::vector<UInteger> &current_surface_curves_types = this->geometry_surfaces_curves_types[isurface];
+    // TYPES MAY ALREADY BE KNOWN FROM THE CAD CACHE
+    const bool known_types = !current_surface_curves_types.empty();
+    UInteger counter = 0;
+    for (TopExp_Explorer explorer_edge(this->topo_faces[isurface],TopAbs_EDGE); explorer_edge.More(); explorer_edge.Next())
+    {
+        // GET THE EDGES
+        TopoDS_Edge current_edge = TopoDS::Edge(explorer_edge.Current());
+        // CONVERT THEM TO GEOM_CURVE
+        Real first, last;
+        Handle_Geom_Curve curve = BRep_Tool::Curve(current_edge,first,last);
+        // STORE HANDLE IN THE CONTAINER
+        current_surface_curves.push_back(curve);
 
+        if (!known_types)
+        {
+            current_surface_curves_types.push_back(BRepAdaptor_Curve(current_edge).GetType());
+        }
+        counter++;
     }
+    if (counter != current_surface_curves_types.size())
+    {
+        throw std::runtime_error("Cached CAD model does not match the imported shape");
+    }
+    this->surfaces_curves_materialised[isurface] = true;
 }
 
 std::vector<Real> PostMeshBase::ObtainGeomVertices()
@@ -556,6 +1219,7 @@ std::vector<Real> PostMeshBase::ObtainGeomVertices()
 
 void PostMeshBase::ComputeProjectionCriteria()
 {
+    PostMeshPhase phase(this->stats,"ComputeProjectionCriteria");
     // IF NOT INITIALISED THEN COMPUTE
     assert((this->ndim==2 || this->ndim==3) && "Unknown number of dimensions");
 
@@ -614,29 +1278,269 @@ void PostMeshBase::ComputeProjectionCriteria()
     }
 }
 
+Integer PostMeshBase::GetDirichletDataSize()
+{
+    PostMeshPhase phase(this->stats,"GetDirichletData");
+    return this->UniqueDirichletNodes();
+}
+
+void PostMeshBase::FillDirichletData(Integer *nodes_dir_out, Real *displacements_BC_out)
+{
+    PostMeshPhase phase(this->stats,"GetDirichletData");
+    //! WRITE THE UNIQUE DIRICHLET NODES AND THEIR ndim DISPLACEMENTS (ROW-MAJOR)
+    //! INTO CALLER-PROVIDED BUFFERS OF GetDirichletDataSize() AND
+    //! ndim*GetDirichletDataSize() ENTRIES
+    this->WriteDirichletData(nodes_dir_out,displacements_BC_out);
+}
+
+Integer PostMeshBase::UniqueDirichletNodes()
+{
+    //! NUMBER OF UNIQUE DIRICHLET NODES. THE FIRST OCCURRENCE OF EVERY NODE IN
+    //! nodes_dir, IN ASCENDING NODE ORDER, IS KEPT FOR WriteDirichletData
+    const Integer n = this->nodes_dir.size();
+    const Integer no_points = this->mesh_points.rows();
+    this->dirichlet_unique.clear();
+    this->dirichlet_unique_valid = true;
+    if (n==0) return 0;
+
+    if (Integer(this->nodes_dir.maxCoeff()) >= no_points)
+    {
+        // NODE NUMBERS ARE NOT DENSE IN THE MESH - STABLE SORT, SO THE FIRST OF
+        // EQUAL NODES IS THE FIRST OCCURRENCE
+        std::vector<std::uint64_t> nodes(this->nodes_dir.data(),this->nodes_dir.data()+n);
+        const std::vector<Integer> sorter = cnp::radix_argsort(nodes);
+        for (Integer i=0; i<n; ++i)
+        {
+            if (i==0 || nodes[sorter[i]] != nodes[sorter[i-1]])
+            {
+                this->dirichlet_unique.push_back(sorter[i]);
+            }
+        }
+        return this->dirichlet_unique.size();
+    }
+
+    // MARK EVERY MESH NODE WITH ITS FIRST OCCURRENCE IN nodes_dir. THE ATOMIC
+    // MINIMUM MAKES THE RESULT INDEPENDENT OF THE THREAD SCHEDULE
+    std::vector<std::atomic<Integer> > first(no_points);
+    parallel_for(0,no_points,[&](Integer lo, Integer hi){
+        for (Integer i=lo; i<hi; ++i) first[i].store(n,std::memory_order_relaxed);
+    },65536);
+    parallel_for(0,n,[&](Integer lo, Integer hi){
+        for (Integer i=lo; i<hi; ++i)
+        {
+            std::atomic<Integer> &marker = first[this->nodes_dir(i)];
+            Integer current = marker.load(std::memory_order_relaxed);
+            while (i < current && !marker.compare_exchange_weak(current,i,std::memory_order_relaxed)) {}
+        }
+    },4096);
+
+    // COMPACT THE MARKED NODES IN ASCENDING ORDER: COUNT PER CHUNK, PREFIX SUM, FILL
+    const Integer nchunks = std::max(Integer(1),std::min(GetNumberOfThreads(),no_points/65536));
+    std::vector<Integer> offsets(nchunks+1,0);
+    parallel_for(0,nchunks,[&](Integer lo, Integer hi){
+        for (Integer t=lo; t<hi; ++t)
+            for (Integer i=no_points*t/nchunks; i<no_points*(t+1)/nchunks; ++i)
+                offsets[t+1] += first[i].load(std::memory_order_relaxed) < n;
+    });
+    std::partial_sum(offsets.begin(),offsets.end(),offsets.begin());
+
+    this->dirichlet_unique.resize(offsets[nchunks]);
+    parallel_for(0,nchunks,[&](Integer lo, Integer hi){
+        for (Integer t=lo; t<hi; ++t)
+        {
+            Integer counter = offsets[t];
+            for (Integer i=no_points*t/nchunks; i<no_points*(t+1)/nchunks; ++i)
+            {
+                const Integer idx = first[i].load(std::memory_order_relaxed);
+                if (idx < n) this->dirichlet_unique[counter++] = idx;
+            }
+        }
+    });
+
+    return this->dirichlet_unique.size();
+}
+
+void PostMeshBase::WriteDirichletData(Integer *nodes_dir_out, Real *displacements_BC_out)
+{
+    //! FillDirichletData WITHOUT ITS PHASE, SO THAT THE PUBLIC ENTRY POINTS
+    //! TIME THE WORK EXACTLY ONCE
+    if (!this->dirichlet_unique_valid)
+    {
+        this->UniqueDirichletNodes();
+    }
+    if (this->displacements_BC.rows() != Integer(this->nodes_dir.size()) ||
+        this->displacements_BC.cols() < Integer(this->ndim))
+    {
+        throw std::runtime_error("Dirichlet data is not available. Project the mesh first");
+    }
+
+    const UInteger ndim = this->ndim;
+    parallel_for(0,this->dirichlet_unique.size(),[&](Integer lo, Integer hi){
+        for (Integer i=lo; i<hi; ++i)
+        {
+            const Integer idx = this->dirichlet_unique[i];
+            nodes_dir_out[i] = this->nodes_dir(idx);
+            for (UInteger j=0; j<ndim; ++j)
+            {
+                displacements_BC_out[ndim*i+j] = this->displacements_BC(idx,j);
+            }
+        }
+    },4096);
+
+    this->InvalidateDirichletData();
+}
+
 DirichletData PostMeshBase::GetDirichletData()
 {
+    PostMeshPhase phase(this->stats,"GetDirichletData");
     // OBTAIN DIRICHLET DATA
     DirichletData Dirichlet_data;
-    // CONVERT FROM EIGEN TO STL VECTOR
-    std::vector<Integer> nodes_Dirichlet_data_stl;
-    nodes_Dirichlet_data_stl.assign(this->nodes_dir.data(),this->nodes_dir.data()+this->nodes_dir.rows());
-    // FIND UNIQUE VALUES OF DIRICHLET DATA
-    std::vector<Integer> idx;
-    std::tie(std::ignore,idx) = cnp::unique(nodes_Dirichlet_data_stl,true);
+    Dirichlet_data.nodes_dir_size = this->UniqueDirichletNodes();
+    Dirichlet_data.nodes_dir_out_stl.resize(Dirichlet_data.nodes_dir_size);
+    Dirichlet_data.displacement_BC_stl.resize(this->ndim*Dirichlet_data.nodes_dir_size);
+    this->WriteDirichletData(Dirichlet_data.nodes_dir_out_stl.data(),Dirichlet_data.displacement_BC_stl.data());
 
-    Dirichlet_data.nodes_dir_out_stl.resize(idx.size());
-    Dirichlet_data.displacement_BC_stl.resize(this->ndim*idx.size());
-    Dirichlet_data.nodes_dir_size = idx.size();
+    return Dirichlet_data;
+}
 
-    for (UInteger i=0; i<idx.size(); ++i)
+void PostMeshBase::WriteCurvedMeshVTU(const char *filename, const Eigen::Ref<const Eigen::MatrixIndexUI> &boundary,
+    const std::vector<Integer> &listboundary, const Eigen::MatrixIndexI &dirichlet, const char *id_name)
+{
+    //! STREAM THE CURVED MESH TO A BINARY APPENDED VTU FILE. POINTS ARE THE
+    //! UNSCALED MESH POINTS WITH THE DIRICHLET DISPLACEMENTS APPLIED AND THE
+    //! CELLS ARE THE ELEMENTS FOLLOWED BY THE PROJECTED BOUNDARY FACES/EDGES,
+    //! ALL AS VTK LAGRANGE CELLS. THE ID OF THE CAD ENTITY AND THE PROJECTION
+    //! RESIDUAL ARE WRITTEN AS CELL DATA (-1 AND 0 FOR THE ELEMENTS)
+    const Integer npoints = this->mesh_points.rows();
+    const Integer nelem = this->mesh_elements.rows();
+    const Integer nboundary = listboundary.size();
+    const Integer nelem_nodes = this->mesh_elements.cols();
+    const Integer nboundary_nodes = boundary.cols();
+
+    const std::string boundary_type = pio::ElementBoundaryType(this->mesh_element_type);
+    const Integer p = pio::InferElementDegree(this->mesh_element_type,nelem_nodes);
+    if (p < 1 || (nboundary > 0 && pio::NbElementNodes(boundary_type,p) != nboundary_nodes))
     {
-        Dirichlet_data.nodes_dir_out_stl[i] = nodes_Dirichlet_data_stl[idx[i]];
-        for (UInteger j=0; j<this->ndim; ++j)
+        throw std::invalid_argument("Mesh connectivity does not correspond to complete Lagrange elements");
+    }
+    const std::vector<Integer> element_permutation = pio::PostMeshToVTKPermutation(this->mesh_element_type,p);
+    const std::vector<Integer> boundary_permutation = pio::PostMeshToVTKPermutation(boundary_type,p);
+
+    auto vtk_cell_type = [](const std::string &element_type) -> std::uint8_t {
+        if (element_type=="line") return 68;
+        if (element_type=="tri") return 69;
+        if (element_type=="quad") return 70;
+        if (element_type=="tet") return 71;
+        return 72;
+    };
+
+    // DISPLACED NODES IN ASCENDING NODE ORDER. A NODE SHARED BY SEVERAL
+    // FACES/EDGES TAKES THE DISPLACEMENT OF ITS FIRST OCCURRENCE, AS IN
+    // GetDirichletData
+    const Integer ndisplaced = this->displacements_BC.rows() == Integer(this->nodes_dir.size()) ? this->nodes_dir.size() : 0;
+    std::vector<std::uint64_t> displaced_nodes(this->nodes_dir.data(),this->nodes_dir.data()+ndisplaced);
+    const std::vector<Integer> displaced_order = cnp::radix_argsort(displaced_nodes);
+
+    pio::VTUStream vtu(filename,npoints,nelem+nboundary);
+    vtu.DeclareArray<Real>("Points","",3,3*npoints);
+    vtu.DeclareArray<Integer>("Cells","connectivity",1,nelem*nelem_nodes+nboundary*nboundary_nodes);
+    vtu.DeclareArray<Integer>("Cells","offsets",1,nelem+nboundary);
+    vtu.DeclareArray<std::uint8_t>("Cells","types",1,nelem+nboundary);
+    vtu.DeclareArray<Real>("PointData","Displacement",3,3*npoints);
+    vtu.DeclareArray<Integer>("CellData",id_name,1,nelem+nboundary);
+    vtu.DeclareArray<Real>("CellData","ProjectionResidual",1,nelem+nboundary);
+    vtu.WriteHeader();
+
+    const Integer chunk = POSTMESH_VTU_CHUNK;
+    std::vector<Real> real_buffer;
+    std::vector<Integer> integer_buffer;
+    std::vector<std::uint8_t> type_buffer;
+
+    // POINTS (with_points) OR DISPLACEMENTS (!with_points), BOTH FROM A
+    // SINGLE WALK OVER THE SORTED DISPLACED NODES
+    auto stream_points = [&](bool with_points) {
+        Integer next = 0;
+        for (Integer lo=0; lo<npoints; lo+=chunk)
         {
-            Dirichlet_data.displacement_BC_stl[this->ndim*i+j] = this->displacements_BC(idx[i],j);
+            const Integer hi = std::min(lo+chunk,npoints);
+            real_buffer.assign(3*(hi-lo),0.);
+            if (with_points)
+            {
+                for (Integer i=lo; i<hi; ++i)
+                    for (UInteger j=0; j<this->ndim; ++j)
+                        real_buffer[3*(i-lo)+j] = this->mesh_points(i,j)/this->scale;
+            }
+            for (; next<ndisplaced && Integer(displaced_nodes[displaced_order[next]])<hi; ++next)
+            {
+                if (next>0 && displaced_nodes[displaced_order[next-1]]==displaced_nodes[displaced_order[next]]) continue;
+                const Integer node = displaced_nodes[displaced_order[next]];
+                for (UInteger j=0; j<this->ndim; ++j)
+                    real_buffer[3*(node-lo)+j] += this->displacements_BC(displaced_order[next],j);
+            }
+            vtu.Write(real_buffer.data(),real_buffer.size());
         }
+    };
+
+    stream_points(true);
+
+    // CONNECTIVITY
+    for (Integer lo=0; lo<nelem; lo+=chunk)
+    {
+        const Integer hi = std::min(lo+chunk,nelem);
+        integer_buffer.resize((hi-lo)*nelem_nodes);
+        for (Integer i=lo; i<hi; ++i)
+            for (Integer j=0; j<nelem_nodes; ++j)
+                integer_buffer[(i-lo)*nelem_nodes+j] = this->mesh_elements(i,element_permutation[j]);
+        vtu.Write(integer_buffer.data(),integer_buffer.size());
+    }
+    for (Integer lo=0; lo<nboundary; lo+=chunk)
+    {
+        const Integer hi = std::min(lo+chunk,nboundary);
+        integer_buffer.resize((hi-lo)*nboundary_nodes);
+        for (Integer i=lo; i<hi; ++i)
+            for (Integer j=0; j<nboundary_nodes; ++j)
+                integer_buffer[(i-lo)*nboundary_nodes+j] = boundary(listboundary[i],boundary_permutation[j]);
+        vtu.Write(integer_buffer.data(),integer_buffer.size());
     }
 
-    return Dirichlet_data;
+    // OFFSETS AND TYPES
+    for (Integer lo=0; lo<nelem+nboundary; lo+=chunk)
+    {
+        const Integer hi = std::min(lo+chunk,nelem+nboundary);
+        integer_buffer.resize(hi-lo);
+        for (Integer i=lo; i<hi; ++i)
+            integer_buffer[i-lo] = i<nelem ? (i+1)*nelem_nodes : nelem*nelem_nodes+(i-nelem+1)*nboundary_nodes;
+        vtu.Write(integer_buffer.data(),integer_buffer.size());
+    }
+    for (Integer lo=0; lo<nelem+nboundary; lo+=chunk)
+    {
+        const Integer hi = std::min(lo+chunk,nelem+nboundary);
+        type_buffer.resize(hi-lo);
+        for (Integer i=lo; i<hi; ++i)
+            type_buffer[i-lo] = vtk_cell_type(i<nelem ? this->mesh_element_type : boundary_type);
+        vtu.Write(type_buffer.data(),type_buffer.size());
+    }
+
+    stream_points(false);
+
+    // CELL DATA
+    const bool has_residuals = this->projection_residuals.rows() == nboundary;
+    for (Integer lo=0; lo<nelem+nboundary; lo+=chunk)
+    {
+        const Integer hi = std::min(lo+chunk,nelem+nboundary);
+        integer_buffer.resize(hi-lo);
+        for (Integer i=lo; i<hi; ++i)
+            integer_buffer[i-lo] = i<nelem ? -1 : dirichlet(i-nelem,dirichlet.cols()-1);
+        vtu.Write(integer_buffer.data(),integer_buffer.size());
+    }
+    for (Integer lo=0; lo<nelem+nboundary; lo+=chunk)
+    {
+        const Integer hi = std::min(lo+chunk,nelem+nboundary);
+        real_buffer.resize(hi-lo);
+        for (Integer i=lo; i<hi; ++i)
+            real_buffer[i-lo] = (i<nelem || !has_residuals) ? 0. : this->projection_residuals(i-nelem);
+        vtu.Write(real_buffer.data(),real_buffer.size());
+    }
+
+    vtu.Close();
 }
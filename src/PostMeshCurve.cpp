@@ -22,23 +22,7 @@ PostMeshCurve& PostMeshCurve::operator=(const PostMeshCurve& other) \
 noexcept(std::is_copy_assignable<PostMeshCurve>::value)
     {
         // COPY ASSIGNMENT OPERATOR
-        this->mesh_elements = other.mesh_elements;
-        this->mesh_points = other.mesh_points;
-        this->mesh_edges = other.mesh_edges;
-        this->mesh_faces = other.mesh_faces;
-        this->projection_criteria = other.projection_criteria;
-        this->degree = other.degree;
-        this->imported_shape = other.imported_shape;
-        this->no_of_shapes = other.no_of_shapes;
-        this->geometry_points = other.geometry_points;
-        this->geometry_curves = other.geometry_curves;
-        this->geometry_surfaces = other.geometry_surfaces;
-        this->geometry_curves_types = other.geometry_curves_types;
-        this->geometry_surfaces_types = other.geometry_surfaces_types;
-        this->displacements_BC = other.displacements_BC;
-        this->index_nodes = other.index_nodes;
-        this->nodes_dir = other.nodes_dir;
-        this->fekete = other.fekete;
+        PostMeshBase::operator=(other);
 
         this->ndim = other.ndim;
         this->mesh_element_type = other.mesh_element_type;
@@ -71,23 +55,7 @@ PostMeshCurve::PostMeshCurve(PostMeshCurve&& other) noexcept :
 PostMeshCurve& PostMeshCurve::operator=(PostMeshCurve&& other) noexcept
     {
         // MOVE ASSIGNMENT OPERATOR
-        this->mesh_elements = std::move(other.mesh_elements);
-        this->mesh_points = std::move(other.mesh_points);
-        this->mesh_edges = std::move(other.mesh_edges);
-        this->mesh_faces = std::move(other.mesh_faces);
-        this->projection_criteria = std::move(other.projection_criteria);
-        this->degree = other.degree;
-        this->imported_shape = std::move(other.imported_shape);
-        this->no_of_shapes = other.no_of_shapes;
-        this->geometry_points = std::move(other.geometry_points);
-        this->geometry_curves = std::move(other.geometry_curves);
-        this->geometry_surfaces = std::move(other.geometry_surfaces);
-        this->geometry_curves_types = std::move(other.geometry_curves_types);
-        this->geometry_surfaces_types = std::move(other.geometry_surfaces_types);
-        this->displacements_BC = std::move(other.displacements_BC);
-        this->index_nodes = std::move(other.index_nodes);
-        this->nodes_dir = std::move(other.nodes_dir);
-        this->fekete = std::move(other.fekete);
+        PostMeshBase::operator=(std::move(other));
 
         this->ndim = other.ndim;
         this->mesh_element_type = other.mesh_element_type;
@@ -233,6 +201,17 @@ void PostMeshCurve::GetGeomPointsOnCorrespondingEdges()
 {
     this->geometry_points_on_curves.clear();
 
+    const pio::ArrayRecord *cached_points = this->FindCADCache("edge_vertices",pio::DTYPE_FLOAT64,-1,3);
+    if (cached_points != nullptr)
+    {
+        auto points = this->cad_cache->View<Real>(*cached_points);
+        for (Integer iedge=0; 2*iedge+1<points.rows(); ++iedge)
+        {
+            this->geometry_points_on_curves.push_back(points.middleRows(2*iedge,2));
+        }
+        return;
+    }
+
     for (TopExp_Explorer explorer_edge(this->imported_shape,TopAbs_EDGE); explorer_edge.More(); explorer_edge.Next())
     {
         // GET THE EDGES
@@ -253,6 +232,16 @@ void PostMeshCurve::GetGeomPointsOnCorrespondingEdges()
         }
         this->geometry_points_on_curves.push_back(current_edge_coords);
     }
+
+    if (!this->cad_cache_key.empty())
+    {
+        Eigen::MatrixR points(2*this->geometry_points_on_curves.size(),3);
+        for (UInteger iedge=0; iedge<this->geometry_points_on_curves.size(); ++iedge)
+        {
+            points.middleRows(2*iedge,2) = this->geometry_points_on_curves[iedge];
+        }
+        this->UpdateCADCache({pio::MakeArrayDescriptor("edge_vertices",points)});
+    }
 }
 
 void PostMeshCurve::GetInternalCurveScale()
@@ -261,7 +250,7 @@ void PostMeshCurve::GetInternalCurveScale()
     for (UInteger icurve=0; icurve<this->geometry_curves.size(); ++icurve)
     {
         Handle_Geom_Curve current_curve = this->geometry_curves[icurve];
-        if (this->geometry_curves_types[icurve]!=0)
+        if (this->CurveType(icurve)!=0)
         {
             this->curve_to_parameter_scale_U(icurve) = \
                     std::abs(current_curve->LastParameter() - \
@@ -278,7 +267,8 @@ void PostMeshCurve::GetInternalCurveScale()
 
 void PostMeshCurve::IdentifyCurvesContainingEdges()
 {
-    this->dirichlet_edges = Eigen::MatrixI::Zero(this->mesh_edges.rows(),this->ndim+1);
+    PostMeshPhase phase(this->stats,"IdentifyCurvesContainingEdges");
+    this->dirichlet_edges = Eigen::MatrixIndexI::Zero(this->mesh_edges.rows(),this->ndim+1);
     this->listedges.clear();
     auto index_edge = 0;
 
@@ -315,12 +305,13 @@ void PostMeshCurve::IdentifyCurvesContainingEdges()
                 try
                 {
                     GeomAPI_ProjectPointOnCurve proj;
+                    ++this->stats.projections_on_curve;
                     proj.Init(middle_point,this->geometry_curves[icurve]);
                     mid_distance = proj.LowerDistance();
                 }
                 catch (StdFail_NotDone)
                 {
-                    // StdFail_NotDone ISSUE - DO NOTHING
+                    ++this->stats.projection_failures;
                 }
                 if (mid_distance < min_mid_distance)
                 {
@@ -334,13 +325,14 @@ void PostMeshCurve::IdentifyCurvesContainingEdges()
         }
     }
 
-    auto arr_rows = cnp::arange(static_cast<Integer>(index_edge));
-    auto arr_cols = cnp::arange(static_cast<Integer>(ndim)+1);
-    this->dirichlet_edges = cnp::take(this->dirichlet_edges,arr_rows,arr_cols);
+    this->dirichlet_edges.conservativeResize(index_edge,Eigen::NoChange);
 }
 
 void PostMeshCurve::ProjectMeshOnCurve()
 {
+    PostMeshPhase phase(this->stats,"ProjectMeshOnCurve",&this->diagnostics);
+    // MESH POINTS ARE MODIFIED IN PLACE
+    this->mesh_points.MakeWritable();
     this->InferInterpolationPolynomialDegree();
 
     this->projection_U = Eigen::MatrixR::Zero(this->dirichlet_edges.rows(),this->ndim);
@@ -366,22 +358,24 @@ void PostMeshCurve::ProjectMeshOnCurve()
             // CHECK IF WE ARE ON THE CURVE INTERSECTION
             if (std::abs(x1_curve-x) < projection_precision && \
                     std::abs(y1_curve-y) < projection_precision && \
-                    this->geometry_curves_types[icurve]!=GeomAbs_Line)
+                    this->CurveType(icurve)!=GeomAbs_Line)
             {
                 // PROJECT THE CURVE VERTEX INSTEAD OF THE EDGE NODE 
                 // THIS IS NECESSARY TO ENSURE SUCCESSFUL PROJECTION
                 x = x1_curve;
                 y = y1_curve;
+                ++this->stats.vertex_snaps;
 
                 this->mesh_points(this->dirichlet_edges(iedge,inode),0) = x;
                 this->mesh_points(this->dirichlet_edges(iedge,inode),1) = y;
             }
             else if (std::abs(x2_curve-x) < projection_precision && \
                      std::abs(y2_curve-y) < projection_precision && \
-                     this->geometry_curves_types[icurve]!=GeomAbs_Line)
+                     this->CurveType(icurve)!=GeomAbs_Line)
             {
                 x = x2_curve;
                 y = y2_curve;
+                ++this->stats.vertex_snaps;
 
                 this->mesh_points(this->dirichlet_edges(iedge,inode),0) = x;
                 this->mesh_points(this->dirichlet_edges(iedge,inode),1) = y;
@@ -393,12 +387,15 @@ void PostMeshCurve::ProjectMeshOnCurve()
                 auto node_to_be_projected = gp_Pnt(x,y,0.0);
                 // PROJECT THE NODES ON THE CURVE AND GET THE PARAMETER U
                 GeomAPI_ProjectPointOnCurve proj;
+                ++this->stats.projections_on_curve;
                 proj.Init(node_to_be_projected,this->geometry_curves[icurve]);
                 parameterU = proj.LowerDistanceParameter();
             }
             catch (StdFail_NotDone)
             {
-                warn("The edge node was not projected to the right curve. Curve number: ",icurve);
+                ++this->stats.projection_failures;
+                this->diagnostics.Report(SEVERITY_WARNING,"The edge node was not projected to the right curve",
+                    "Curve number:",icurve);
             }
 
             // GET CURVE LENGTH
@@ -406,7 +403,7 @@ void PostMeshCurve::ProjectMeshOnCurve()
 
             // STORE PROJECTION POINT PARAMETER ON THE CURVE (NORMALISED)
             //this->projection_U(iedge,inode) = this->scale*parameterU/curve_length; //# THIS
-            auto U0 = this->geometry_curves_types[icurve]==0 ? 0. : this->geometry_curves[icurve]->FirstParameter();
+            auto U0 = this->CurveType(icurve)==0 ? 0. : this->geometry_curves[icurve]->FirstParameter();
             this->projection_U(iedge,inode) =   this->scale*(parameterU-U0)/curve_length;
         }
     }
@@ -419,6 +416,7 @@ void PostMeshCurve::ProjectMeshOnCurve()
 
 void PostMeshCurve::RepairDualProjectedParameters()
 {
+    PostMeshPhase phase(this->stats,"RepairDualProjectedParameters");
     auto lengthTol = 1.0e-10;
 
     for (auto iedge=0;iedge<this->dirichlet_edges.rows();++iedge)
@@ -431,7 +429,7 @@ void PostMeshCurve::RepairDualProjectedParameters()
             // GET THE CURRENT EDGE
             Eigen::Matrix<Real,1,2> current_edge_U = this->projection_U.row(iedge);
             // SORT IT
-            std::sort(current_edge_U.data(),current_edge_U.data()+current_edge_U.cols());
+            cnp::sorting_network<2>::sort(current_edge_U.data());
             // GET THE FIRST AND LAST PARAMETERS OF THIS CURVE
             auto u1 = current_curve->FirstParameter()/cnp::length(current_curve,1.0/this->scale);
             auto u2 = current_curve->LastParameter()/cnp::length(current_curve,1.0/this->scale);
@@ -485,25 +483,27 @@ void PostMeshCurve::CurvesToBsplineCurves()
 
 void PostMeshCurve::MeshPointInversionCurve()
 {
+    PostMeshPhase phase(this->stats,"MeshPointInversionCurve",&this->diagnostics);
+    // MESH POINTS ARE MODIFIED IN PLACE
+    this->mesh_points.MakeWritable();
     this->no_dir_edges = this->dirichlet_edges.rows();
     Integer no_edge_nodes = this->mesh_edges.cols();
-    Eigen::MatrixI arr_row = Eigen::Map<Eigen::Matrix<Integer,
-        Eigen::Dynamic,1> >(this->listedges.data(),this->listedges.size());
-    auto arr_col = cnp::arange(no_edge_nodes);
-    this->nodes_dir = cnp::take(this->mesh_edges,arr_row,arr_col);
-    this->nodes_dir = cnp::ravel(this->nodes_dir);
-    this->index_nodes = cnp::arange(no_edge_nodes);
+    this->InvalidateDirichletData();
+    this->nodes_dir = cnp::take_rows(this->mesh_edges,this->listedges,true);
     this->displacements_BC = Eigen::MatrixR::Zero(this->no_dir_edges*no_edge_nodes,this->ndim);
+    this->projection_residuals = Eigen::MatrixR::Zero(this->no_dir_edges,1);
 
+    GeomAPI_ProjectPointOnCurve proj;
 
     for (auto idir=0; idir< this->no_dir_edges; ++idir)
     {
         auto id_curve = this->dirichlet_edges(idir,2);
-        Handle_Geom_Curve current_curve = this->geometry_curves[id_curve];
+        const Handle_Geom_Curve &current_curve = this->geometry_curves[id_curve];
+        // FIRST ROW OF THE EDGE IN nodes_dir AND displacements_BC
+        const Integer node_offset = idir*no_edge_nodes;
 
         for (auto j=0; j<no_edge_nodes;++j)
         {
-            GeomAPI_ProjectPointOnCurve proj;
             auto x = this->mesh_points(this->mesh_edges(this->listedges[idir],j),0);
             auto y = this->mesh_points(this->mesh_edges(this->listedges[idir],j),1);
             auto xEq = gp_Pnt(x,y,0.0);
@@ -513,58 +513,65 @@ void PostMeshCurve::MeshPointInversionCurve()
 
             try
             {
+                ++this->stats.projections_on_curve;
                 proj.Init(xEq,current_curve);
                 uEq = proj.LowerDistanceParameter();
                 current_curve->D0(uEq,xEq);
             }
             catch (StdFail_NotDone)
             {
+                ++this->stats.projection_failures;
                 try
                 {
                     // TRY NEWTON-RAPSHON PROJECTION METHOD WITH LOWER PRECISION
+                    ++this->stats.newton_on_curve;
                     ShapeAnalysis_Curve proj_Newton;
                     auto Newton_precision = projection_precision < 1.0e-05 ? 1.0e-5: projection_precision;
                     proj_Newton.Project(current_curve,xEq1,Newton_precision,xEq,uEq,True);
                 }
                 catch (StdFail_NotDone)
                 {
-                    warn("Could not project node on to the curve. Candidate curve number is:",
-                        id_curve,"Candidate node is:",this->mesh_edges(this->listedges[idir],j));
+                    ++this->stats.projection_failures;
+                    this->diagnostics.Report(SEVERITY_WARNING,"Could not project node on to the curve",
+                        "Candidate curve number is:",id_curve,"Candidate node is:",this->mesh_edges(this->listedges[idir],j));
                 }
             }
 
-            Eigen::MatrixR gp_pnt_old = (this->mesh_points.row(this->nodes_dir(this->index_nodes( j ))).array()/this->scale);
+            auto gp_pnt_old = (this->mesh_points.row(this->nodes_dir(node_offset+j)).array()/this->scale);
+            // LARGEST DISTANCE A NODE OF THE EDGE IS MOVED TO REACH THE CURVE
+            this->projection_residuals(idir) = std::max(this->projection_residuals(idir),
+                std::hypot(xEq.X()/this->scale - gp_pnt_old(0), xEq.Y()/this->scale - gp_pnt_old(1)));
 
             if (j>static_cast<decltype(j)>(this->ndim)-1)
             {
                 // FOR NON-VERTEX NODES GET THE REQUIRED DISPLACEMENT
-                this->displacements_BC(this->index_nodes(j),0) = (xEq.X()/this->scale - gp_pnt_old(0));
-                this->displacements_BC(this->index_nodes(j),1) = (xEq.Y()/this->scale - gp_pnt_old(1));
+                this->displacements_BC(node_offset+j,0) = (xEq.X()/this->scale - gp_pnt_old(0));
+                this->displacements_BC(node_offset+j,1) = (xEq.Y()/this->scale - gp_pnt_old(1));
             }
             else
             {
                 // FOR VERTEX NODES KEEP THE DISPLACEMENT ZERO
-                this->displacements_BC(this->index_nodes(j),0) = 0;
-                this->displacements_BC(this->index_nodes(j),1) = 0;
+                this->displacements_BC(node_offset+j,0) = 0;
+                this->displacements_BC(node_offset+j,1) = 0;
                 // BUT UPDATE THE MESH POINTS
                 this->mesh_points(this->mesh_edges(this->listedges[idir],j),0) = xEq.X();
                 this->mesh_points(this->mesh_edges(this->listedges[idir],j),1) = xEq.Y();
             }
         }
-        this->index_nodes = ((this->index_nodes).array()+no_edge_nodes).eval().matrix();
     }
 }
 
 void PostMeshCurve::MeshPointInversionCurveArcLength()
 {
+    PostMeshPhase phase(this->stats,"MeshPointInversionCurveArcLength");
+    // MESH POINTS ARE MODIFIED IN PLACE
+    this->mesh_points.MakeWritable();
     this->no_dir_edges = this->dirichlet_edges.rows();
     Integer no_edge_nodes = this->mesh_edges.cols();
-    Eigen::MatrixI arr_row = Eigen::Map<Eigen::Matrix<Integer,Eigen::Dynamic,1> >(this->listedges.data(),this->listedges.size());
-    auto arr_col = cnp::arange(no_edge_nodes);
-    this->nodes_dir = cnp::take(this->mesh_edges,arr_row,arr_col);
-    this->nodes_dir = cnp::ravel(this->nodes_dir);
-    this->index_nodes = cnp::arange(no_edge_nodes);
+    this->InvalidateDirichletData();
+    this->nodes_dir = cnp::take_rows(this->mesh_edges,this->listedges,true);
     this->displacements_BC = Eigen::MatrixR::Zero(this->no_dir_edges*no_edge_nodes,this->ndim);
+    this->projection_residuals = Eigen::MatrixR::Zero(this->no_dir_edges,1);
 
     // FIND CURVE LENGTH AND LAST PARAMETER SCALE
     this->GetInternalCurveScale();
@@ -575,7 +582,8 @@ void PostMeshCurve::MeshPointInversionCurveArcLength()
     for (auto idir=0; idir< this->no_dir_edges; ++idir)
     {
         auto id_curve = this->dirichlet_edges(idir,2);
-        Handle_Geom_Curve current_curve = this->geometry_curves[id_curve];
+        const Handle_Geom_Curve &current_curve = this->geometry_curves[id_curve];
+        const Integer node_offset = idir*no_edge_nodes;
         auto length_current_curve = cnp::length(current_curve,1/this->scale);
         auto internal_scale = 1./this->curve_to_parameter_scale_U(id_curve);
         GeomAdaptor_Curve current_curve_adapt(current_curve);
@@ -583,7 +591,7 @@ void PostMeshCurve::MeshPointInversionCurveArcLength()
         for (auto j=0; j<no_edge_nodes;++j)
         {
             auto tol =1.0e-10;
-            auto U0 = this->geometry_curves_types[id_curve]==0 ? 0. : current_curve_adapt.FirstParameter();
+            auto U0 = this->CurveType(id_curve)==0 ? 0. : current_curve_adapt.FirstParameter();
             GCPnts_AbscissaPoint inv;
             Real uEq;
             gp_Pnt xEq;
@@ -612,25 +620,27 @@ void PostMeshCurve::MeshPointInversionCurveArcLength()
 
             }
 
-            Eigen::MatrixR gp_pnt_old = (this->mesh_points.row(this->nodes_dir(this->index_nodes( j ))).array()/this->scale);
+            auto gp_pnt_old = (this->mesh_points.row(this->nodes_dir(node_offset+j)).array()/this->scale);
+            // LARGEST DISTANCE A NODE OF THE EDGE IS MOVED TO REACH THE CURVE
+            this->projection_residuals(idir) = std::max(this->projection_residuals(idir),
+                std::hypot(xEq.X()/this->scale - gp_pnt_old(0), xEq.Y()/this->scale - gp_pnt_old(1)));
 
             if (j>static_cast<decltype(j)>(this->ndim)-1)
             {
                 // FOR NON-VERTEX NODES GET THE REQUIRED DISPLACEMENT
-                this->displacements_BC(this->index_nodes(j),0) = (xEq.X()/this->scale - gp_pnt_old(0));
-                this->displacements_BC(this->index_nodes(j),1) = (xEq.Y()/this->scale - gp_pnt_old(1));
+                this->displacements_BC(node_offset+j,0) = (xEq.X()/this->scale - gp_pnt_old(0));
+                this->displacements_BC(node_offset+j,1) = (xEq.Y()/this->scale - gp_pnt_old(1));
             }
             else
             {
                 // FOR VERTEX NODES KEEP THE DISPLACEMENT ZERO
-                this->displacements_BC(this->index_nodes(j),0) = 0.;
-                this->displacements_BC(this->index_nodes(j),1) = 0.;
+                this->displacements_BC(node_offset+j,0) = 0.;
+                this->displacements_BC(node_offset+j,1) = 0.;
                 // BUT UPDATE THE MESH POINTS
                 this->mesh_points(this->mesh_edges(this->listedges[idir],j),0) = xEq.X();
                 this->mesh_points(this->mesh_edges(this->listedges[idir],j),1) = xEq.Y();
             }
         }
-        this->index_nodes = ((this->index_nodes).array()+no_edge_nodes).eval().matrix();
     }
 }
 
@@ -679,6 +689,7 @@ void PostMeshCurve::GetElementsWithBoundaryEdgesTri()
 
 void PostMeshCurve::GetBoundaryPointsOrder()
 {
+    PostMeshPhase phase(this->stats,"GetBoundaryPointsOrder");
     //! THE ORDER OF BOUNDARY EDGE CONNECTIVITY. NEEDS THE DEGREE TO BE INFERRED A PRIORI
     this->InferInterpolationPolynomialDegree();
 
@@ -692,10 +703,8 @@ void PostMeshCurve::GetBoundaryPointsOrder()
 
     for (auto iedge=0;iedge<this->mesh_edges.rows();++iedge)
     {
-        Eigen::MatrixUI current_edge = this->mesh_edges.row(iedge).transpose();
-        Eigen::MatrixI all_points_cols = cnp::arange(static_cast<Integer>(this->mesh_points.cols()));
-        Eigen::MatrixR current_edge_coordinates = cnp::take(this->mesh_points,current_edge,all_points_cols);
-        current_edge_coordinates = (current_edge_coordinates.array()/1000.).matrix().eval();
+        Eigen::MatrixR current_edge_coordinates = cnp::take_rows(this->mesh_points,&this->mesh_edges(iedge,0),this->mesh_edges.cols());
+        current_edge_coordinates /= 1000.;
 
         std::vector<Real> norm_rows(this->mesh_edges.cols()-2);
         for (auto j=2; j<current_edge_coordinates.rows(); ++j)
@@ -785,3 +794,9 @@ void PostMeshCurve::EstimatedParameterUOnMesh()
         }
     }
 }
+
+void PostMeshCurve::WriteVTU(const char *filename)
+{
+    //! WRITE THE CURVED MESH AND ITS PROJECTED BOUNDARY EDGES TO A BINARY VTU FILE
+    this->WriteCurvedMeshVTU(filename,this->mesh_edges,this->listedges,this->dirichlet_edges,"CurveID");
+}
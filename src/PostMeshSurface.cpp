@@ -17,23 +17,7 @@ PostMeshSurface& PostMeshSurface::operator=(const PostMeshSurface& other)
 noexcept(std::is_copy_assignable<PostMeshSurface>::value)
 {
     // COPY ASSIGNMENT OPERATOR
-    this->mesh_elements = other.mesh_elements;
-    this->mesh_points = other.mesh_points;
-    this->mesh_edges = other.mesh_edges;
-    this->mesh_faces = other.mesh_faces;
-    this->projection_criteria = other.projection_criteria;
-    this->degree = other.degree;
-    this->imported_shape = other.imported_shape;
-    this->no_of_shapes = other.no_of_shapes;
-    this->geometry_points = other.geometry_points;
-    this->geometry_curves = other.geometry_curves;
-    this->geometry_surfaces = other.geometry_surfaces;
-    this->geometry_curves_types = other.geometry_curves_types;
-    this->geometry_surfaces_types = other.geometry_surfaces_types;
-    this->displacements_BC = other.displacements_BC;
-    this->index_nodes = other.index_nodes;
-    this->nodes_dir = other.nodes_dir;
-    this->fekete = other.fekete;
+    PostMeshBase::operator=(other);
 
     this->ndim = other.ndim;
     this->mesh_element_type = other.mesh_element_type;
@@ -58,23 +42,7 @@ PostMeshSurface::PostMeshSurface(PostMeshSurface&& other) noexcept \
 PostMeshSurface& PostMeshSurface::operator=(PostMeshSurface&& other) noexcept
 {
     // MOVE ASSIGNMENT OPERATOR
-    this->mesh_elements = std::move(other.mesh_elements);
-    this->mesh_points = std::move(other.mesh_points);
-    this->mesh_edges = std::move(other.mesh_edges);
-    this->mesh_faces = std::move(other.mesh_faces);
-    this->projection_criteria = std::move(other.projection_criteria);
-    this->degree = other.degree;
-    this->imported_shape = std::move(other.imported_shape);
-    this->no_of_shapes = other.no_of_shapes;
-    this->geometry_points = std::move(other.geometry_points);
-    this->geometry_curves = std::move(other.geometry_curves);
-    this->geometry_surfaces = std::move(other.geometry_surfaces);
-    this->geometry_curves_types = std::move(other.geometry_curves_types);
-    this->geometry_surfaces_types = std::move(other.geometry_surfaces_types);
-    this->displacements_BC = std::move(other.displacements_BC);
-    this->index_nodes = std::move(other.index_nodes);
-    this->nodes_dir = std::move(other.nodes_dir);
-    this->fekete = std::move(other.fekete);
+    PostMeshBase::operator=(std::move(other));
 
     this->ndim = other.ndim;
     this->mesh_element_type = other.mesh_element_type;
@@ -148,6 +116,25 @@ void PostMeshSurface::GetGeomPointsOnCorrespondingFaces()
 {
     //! COMPUTE WHICH GEOMETRICAL POINTS LIE ON WHICH GEMOETRICAL SURFACE
     this->geometry_points_on_surfaces.clear();
+
+    const pio::ArrayRecord *cached_points = this->FindCADCache("face_vertices",pio::DTYPE_FLOAT64,-1,3);
+    const pio::ArrayRecord *cached_offsets = this->FindCADCache("face_vertex_offsets",pio::DTYPE_UINT64,-1,1);
+    if (cached_points != nullptr && cached_offsets != nullptr)
+    {
+        auto points = this->cad_cache->View<Real>(*cached_points);
+        auto offsets = this->cad_cache->View<UInteger>(*cached_offsets);
+        if (pio::ValidOffsets(offsets.data(),offsets.rows(),points.rows()))
+        {
+            for (Integer iface=0; iface+1<offsets.rows(); ++iface)
+            {
+                this->geometry_points_on_surfaces.push_back(
+                    points.middleRows(offsets(iface,0),offsets(iface+1,0)-offsets(iface,0)));
+            }
+            return;
+        }
+        warn("Ignoring invalid cached CAD array","face_vertex_offsets");
+    }
+
     for (TopExp_Explorer explorer_face(this->imported_shape,TopAbs_FACE); explorer_face.More(); explorer_face.Next())
     {
         // GET THE FACES
@@ -176,14 +163,89 @@ void PostMeshSurface::GetGeomPointsOnCorrespondingFaces()
         current_face_coords << current_face_X_, current_face_Y_, current_face_Z_;
         this->geometry_points_on_surfaces.push_back(current_face_coords);
     }
+
+    if (!this->cad_cache_key.empty())
+    {
+        Eigen::MatrixUI offsets = Eigen::MatrixUI::Zero(this->geometry_points_on_surfaces.size()+1,1);
+        for (UInteger iface=0; iface<this->geometry_points_on_surfaces.size(); ++iface)
+        {
+            offsets(iface+1) = offsets(iface) + this->geometry_points_on_surfaces[iface].rows();
+        }
+        Eigen::MatrixR points(offsets(offsets.rows()-1),3);
+        for (UInteger iface=0; iface<this->geometry_points_on_surfaces.size(); ++iface)
+        {
+            points.middleRows(offsets(iface),offsets(iface+1)-offsets(iface)) = this->geometry_points_on_surfaces[iface];
+        }
+        this->UpdateCADCache({pio::MakeArrayDescriptor("face_vertices",points),
+                              pio::MakeArrayDescriptor("face_vertex_offsets",offsets)});
+    }
 }
 
 
+// FIXED SIZE TYPES OF A BOUNDARY FACE WITH NV VERTICES, 3 FOR TETS AND 4
+// FOR HEXES. THE FACE KERNELS BELOW ARE INSTANTIATED FOR BOTH AND DISPATCHED
+// ONCE PER PHASE, SO THEIR VERTEX LOOPS UNROLL AND NEED NO HEAP STORAGE
+template<Integer NV>
+using FaceVertices = Eigen::Matrix<Real,NV,3,POSTMESH_ALIGNED>;
+typedef Eigen::Matrix<Real,1,3,POSTMESH_ALIGNED> FacePoint;
+
+template<Integer NV>
+STATIC ALWAYS_INLINE void GatherFaceVertices(const Eigen::BorrowableMatrixR &points,
+    const Eigen::BorrowableMatrixIndexUI &faces, Integer iface, FaceVertices<NV> &face_vertices)
+{
+    for (Integer i=0; i<NV; ++i) {
+        for (Integer j=0; j<3; ++j) {
+            face_vertices(i,j) = points(faces(iface,i),j);
+        }
+    }
+}
+
+template<Integer NV>
+STATIC ALWAYS_INLINE void SnapToSurfacePoints(const Eigen::MatrixR &surface_points, Real precision,
+    FaceVertices<NV> &face_vertices)
+{
+    //! MOVE THE FACE VERTICES THAT COINCIDE WITH A GEOMETRY POINT OF THE
+    //! SURFACE ONTO IT, WHICH IS NECESSARY FOR A SUCCESSFUL PROJECTION
+    for (Integer surf_iter=0; surf_iter<surface_points.rows(); ++surf_iter)
+    {
+        const Real x_surface = surface_points(surf_iter,0);
+        const Real y_surface = surface_points(surf_iter,1);
+        const Real z_surface = surface_points(surf_iter,2);
+        for (Integer ivertex=0; ivertex<NV; ++ivertex) {
+            if (std::abs(x_surface-face_vertices(ivertex,0)) < precision && \
+                    std::abs(y_surface-face_vertices(ivertex,1)) < precision && \
+                    std::abs(z_surface-face_vertices(ivertex,2)) < precision )
+            {
+                face_vertices(ivertex,0) = x_surface;
+                face_vertices(ivertex,1) = y_surface;
+                face_vertices(ivertex,2) = z_surface;
+                break;
+            }
+        }
+    }
+}
+
+template<Integer NV>
+STATIC ALWAYS_INLINE void FaceGpPoints(const FaceVertices<NV> &face_vertices, std::array<gp_Pnt,NV> &vertices,
+    std::array<gp_Pnt,NV> &edge_mid_points)
+{
+    //! VERTICES AND EDGE MID POINTS. EDGE i JOINS VERTICES i AND i+1 AND
+    //! THE LAST EDGE CLOSES THE FACE
+    for (Integer i=0; i<NV; ++i) {
+        const Integer j = (i+1) % NV;
+        vertices[i] = gp_Pnt(face_vertices(i,0),face_vertices(i,1),face_vertices(i,2));
+        edge_mid_points[i] = gp_Pnt((face_vertices(i,0) + face_vertices(j,0))/2.,
+                                    (face_vertices(i,1) + face_vertices(j,1))/2.,
+                                    (face_vertices(i,2) + face_vertices(j,2))/2.);
+    }
+}
+
 void PostMeshSurface::IdentifySurfacesContainingFaces(Integer activate_bounding_box, Real bb_tolerance)
 {
+    PostMeshPhase phase(this->stats,"IdentifySurfacesContainingFaces",&this->diagnostics);
     //! IDENTIFY GEOMETRICAL SURFACES CONTAINING MESH FACES
     const Integer no_face_vertices = this->GetNoFaceVertices();
-    this->dirichlet_faces = Eigen::MatrixI::Constant(this->mesh_faces.rows(),no_face_vertices+1,-1);
+    this->dirichlet_faces = Eigen::MatrixIndexI::Constant(this->mesh_faces.rows(),no_face_vertices+1,-1);
     this->listfaces.clear();
 
     if (activate_bounding_box)
@@ -191,10 +253,31 @@ void PostMeshSurface::IdentifySurfacesContainingFaces(Integer activate_bounding_
         this->GetBoundingBoxOnSurfaces(bb_tolerance);
     }
 
-    auto index_face = 0;
+    const Integer index_face = no_face_vertices==3 ?
+        this->IdentifySurfacesContainingFacesKernel<3>(activate_bounding_box) :
+        this->IdentifySurfacesContainingFacesKernel<4>(activate_bounding_box);
+
+    // REDUCE THE MATRIX TO GET DIRICHLET FACES
+    this->dirichlet_faces.conservativeResize(index_face,Eigen::NoChange);
+
+    this->IdentifyRemainingSurfacesByProjection();
+}
+
+template<Integer NV>
+Integer PostMeshSurface::IdentifySurfacesContainingFacesKernel(Integer activate_bounding_box)
+{
+    //! FACE LOOP OF IdentifySurfacesContainingFaces. RETURNS THE NUMBER OF
+    //! FACES TO BE PROJECTED
+    Integer index_face = 0;
+    FaceVertices<NV> face_vertices;
+    std::array<gp_Pnt,NV> face_gp_vertices, edge_mid_points;
+    // ONE EXTREMA SOLVER IS RE-INITIALISED FOR EVERY SURFACE AND PERFORMED FOR
+    // EVERY VERTEX, INSTEAD OF CONSTRUCTING ONE PER VERTEX
+    Extrema_ExtPS extrema;
+    extrema.SetFlag(Extrema_ExtFlag_MIN);
 
     // LOOP OVER FACES
-    for (auto iface=0; iface<this->mesh_faces.rows(); ++iface)
+    for (Integer iface=0; iface<this->mesh_faces.rows(); ++iface)
     {
         // ONLY FOR FACES THAT NEED TO BE PROJECTED
         if (this->projection_criteria(iface)==1)
@@ -202,265 +285,120 @@ void PostMeshSurface::IdentifySurfacesContainingFaces(Integer activate_bounding_
             // A LIST OF PROJECTION FACES
             this->listfaces.push_back(iface);
             // FILL DIRICHLET DATA
-            for (auto iter=0;iter<no_face_vertices;++iter)
+            for (Integer iter=0; iter<NV; ++iter)
             {
                this->dirichlet_faces(index_face,iter) = this->mesh_faces(iface,iter);
             }
 
             // GET THE COORDINATES OF THE FACE VERTICES
-            Eigen::MatrixR face_vertices(no_face_vertices,ndim);
-            for (auto i=0; i<no_face_vertices; ++i) {
-                for (UInteger j=0; j<ndim; ++j) {
-                    face_vertices(i,j) = this->mesh_points(this->mesh_faces(iface,i),j);
-                }
-            }
+            GatherFaceVertices<NV>(this->mesh_points,this->mesh_faces,iface,face_vertices);
 
-            std::vector<std::vector<Integer>> mins(no_face_vertices);
+            // SURFACES CONTAINING ALL THE VERTICES OF THE FACE. A SURFACE COUNTS
+            // AS MANY TIMES AS THE FIRST VERTEX LIES ON IT, SO THAT MULTIPLE
+            // EXTREMA OF THE FIRST VERTEX STILL MAKE THE FACE AMBIGUOUS
+            Integer no_common_surfaces = 0;
+            Integer surface_to_project_to = -1;
 
             // LOOP OVER SURFACES
             for (UInteger isurface=0; isurface<this->geometry_surfaces.size(); ++isurface)
             {
                 // CHECK IF THE MESH POINTS AND GEOMETRY POINTS ARE THE SAME
-                for (auto surf_iter=0; surf_iter<geometry_points_on_surfaces[isurface].rows(); ++surf_iter)
-                {
-                    auto x_surface = this->geometry_points_on_surfaces[isurface](surf_iter,0);
-                    auto y_surface = this->geometry_points_on_surfaces[isurface](surf_iter,1);
-                    auto z_surface = this->geometry_points_on_surfaces[isurface](surf_iter,2);
-                    // CHECK IF THE POINT IS ON THE GEOMETRICAL SURFACE
-                    for (auto ivertex = 0; ivertex<no_face_vertices; ++ivertex) {
-                        if (std::abs(x_surface-face_vertices(ivertex,0)) < projection_precision && \
-                                std::abs(y_surface-face_vertices(ivertex,1)) < projection_precision && \
-                                std::abs(z_surface-face_vertices(ivertex,2)) < projection_precision )
-                        {
-                            // PROJECT THE SURFACE VERTEX INSTEAD OF THE FACE NODE
-                            face_vertices(ivertex,0) = x_surface;
-                            face_vertices(ivertex,1) = y_surface;
-                            face_vertices(ivertex,2) = z_surface;
-                            break;
-                        }
-                    }
-                }
+                SnapToSurfacePoints<NV>(this->geometry_points_on_surfaces[isurface],this->projection_precision,face_vertices);
 
                 if (activate_bounding_box)
                 {
                     // GET THE MID-POINT OF THE FACE
-                    Eigen::RowVectorR coord_avg = face_vertices.colwise().sum().array()/no_face_vertices;
+                    const FacePoint coord_avg = face_vertices.colwise().sum()/Real(NV);
 
                     // CHECK IF THE POINT IS OUTSIDE THE BOUNDING BOX
-                    if (coord_avg[0] < bbox_surfaces(isurface,0) ||
-                        coord_avg[1] < bbox_surfaces(isurface,1) ||
-                        coord_avg[2] < bbox_surfaces(isurface,2) ||
-                        coord_avg[0] > bbox_surfaces(isurface,3) ||
-                        coord_avg[1] > bbox_surfaces(isurface,4) ||
-                        coord_avg[2] > bbox_surfaces(isurface,5)) {
+                    if (!this->InBoundingBox(isurface,coord_avg)) {
                         // POINT IS OITSIDE THE BOX, MOVE TO NEXT MESH FACE
                         continue;
                     }
                 }
 
-
                 // VERTEX POINTS
-                std::vector<gp_Pnt> face_gp_vertices(no_face_vertices);
-                for (auto ivertex = 0; ivertex<no_face_vertices; ++ivertex) {
-                    face_gp_vertices[ivertex] = gp_Pnt(face_vertices(ivertex,0),face_vertices(ivertex,1),face_vertices(ivertex,2));
-                }
+                FaceGpPoints<NV>(face_vertices,face_gp_vertices,edge_mid_points);
 
-                BRepAdaptor_Surface adapt_surface(this->topo_faces[isurface]);
+                SurfaceCost &cost = this->stats.Surface(isurface);
+                PostMeshTimer timer(cost.identification_time);
+                const BRepAdaptor_Surface &adapt_surface = this->SurfaceAdaptor(isurface);
 
+                Integer first_vertex_hits = 0;
+                bool on_surface = true;
                 try
                 {
-                    std::vector<Extrema_ExtPS> extrema(no_face_vertices);
-                    for (auto ivertex = 0; ivertex<no_face_vertices; ++ivertex) {
-                        extrema[ivertex] = Extrema_ExtPS(face_gp_vertices[ivertex],adapt_surface,this->projection_precision,
-                                            this->projection_precision,Extrema_ExtFlag_MIN);
-
-                        for (auto extrema_iter=1; extrema_iter<=extrema[ivertex].NbExt(); ++extrema_iter)
+                    extrema.Initialize(adapt_surface,adapt_surface.FirstUParameter(),adapt_surface.LastUParameter(),
+                                       adapt_surface.FirstVParameter(),adapt_surface.LastVParameter(),
+                                       this->projection_precision,this->projection_precision);
+                    for (Integer ivertex=0; ivertex<NV && on_surface; ++ivertex) {
+                        ++this->stats.extrema_on_surface;
+                        ++cost.projections;
+                        ++cost.extrema_calls;
+                        extrema.Perform(face_gp_vertices[ivertex]);
+                        cost.extrema_solutions += extrema.NbExt();
+
+                        Integer hits = 0;
+                        for (auto extrema_iter=1; extrema_iter<=extrema.NbExt(); ++extrema_iter)
                         {
-                            auto point_distance = extrema[ivertex].SquareDistance(extrema_iter);
+                            auto point_distance = extrema.SquareDistance(extrema_iter);
                             if (point_distance/this->scale < this->projection_precision)
                             {
-                                mins[ivertex].push_back(isurface);
+                                ++hits;
                             }
                         }
+                        if (ivertex==0) first_vertex_hits = hits;
+                        on_surface = hits > 0;
                     }
                 }
                 catch (StdFail_NotDone)
                 {
+                    ++this->stats.projection_failures;
+                    ++cost.failures;
+                    on_surface = false;
+                }
 
+                if (on_surface)
+                {
+                    if (no_common_surfaces==0) surface_to_project_to = isurface;
+                    no_common_surfaces += first_vertex_hits;
                 }
             }
 
-            // FIND IF ALL THREE NODES OF THE MESH CAN BE ON ONE SURFACE
-            // auto surface_to_project_to = cnp::intersect(mins_1,mins_2,mins_3);
-            auto surface_to_project_to = mins[0];
-            for (auto ivertex = 1; ivertex<no_face_vertices; ++ivertex) {
-                surface_to_project_to = cnp::intersect(surface_to_project_to,mins[ivertex]);
-            }
-            if (surface_to_project_to.size() == 1)
+            // FIND IF ALL THE VERTICES OF THE FACE CAN BE ON ONE SURFACE
+            if (no_common_surfaces == 1)
             {
-                this->dirichlet_faces(index_face,no_face_vertices) = surface_to_project_to[0];
+                this->dirichlet_faces(index_face,NV) = surface_to_project_to;
             }
-            else if (surface_to_project_to.size() > 1)
+            else if (no_common_surfaces > 1)
             {
-//                 warn("There is more than one surface to project the mesh face", iface, "to");
+                this->diagnostics.Report(SEVERITY_INFO,"More than one surface contains the mesh face","Face:",iface);
+                ++this->stats.unresolved_faces;
             }
-            else if (surface_to_project_to.empty())
+            else
             {
-//                 warn("Could not identify a common surface between three nodes of the mesh face", iface);
+                this->diagnostics.Report(SEVERITY_INFO,"Could not identify a common surface of the vertices of the mesh face","Face:",iface);
+                ++this->stats.unresolved_faces;
             }
             index_face +=1;
         }
     }
-
-    // REDUCE THE MATRIX TO GET DIRICHLET FACES
-    auto arr_rows = cnp::arange(static_cast<Integer>(index_face));
-    auto arr_cols = cnp::arange(no_face_vertices+1);
-    this->dirichlet_faces = cnp::take(this->dirichlet_faces,arr_rows,arr_cols);
-
-    this->IdentifyRemainingSurfacesByProjection();
+    return index_face;
 }
 
 void PostMeshSurface::IdentifyRemainingSurfacesByProjection(Integer activate_bounding_box)
 {
+    PostMeshPhase phase(this->stats,"IdentifyRemainingSurfacesByProjection");
     //! IDENTIFY GEOMETRICAL SURFACES CONTAINING MESH FACES
     const Integer no_face_vertices = this->GetNoFaceVertices();
     // WE WILL CONSIDER PROJECTING THE VERTICES, MID POINT OF EDGES AND THE MEDIAN OF THE FACE
     const Integer no_entities_projected = 2*no_face_vertices + 1;
-    this->projection_ID = Eigen::MatrixI::Zero(this->dirichlet_faces.rows(),no_entities_projected);
-
-    // LOOP OVER DIRCHLET FACES
-    for (auto idir=0; idir<this->dirichlet_faces.rows(); ++idir)
-    {
-        // MESH FACES THAT COULD NOT BE DETERMINED
-        if (this->dirichlet_faces(idir,no_face_vertices)==-1)
-        {
-            // PROJECT IT OVER ALL SURFACES
-            auto min_mid_distance = 1.0e20;
-            auto mid_distance = 1.0e10;
-
-            std::vector<Real> min_vertex_distances(no_face_vertices,1.0e20);
-            std::vector<Real> vertex_distances(no_face_vertices,1.0e10);
-            std::vector<Real> min_edge_distances(no_face_vertices,1.0e20);
-            std::vector<Real> edge_distances(no_face_vertices,1.0e10);
-
-            // GET THE COORDINATES OF THE FACE VERTICES
-            Eigen::MatrixR face_vertices(no_face_vertices,ndim);
-            for (auto i=0; i<no_face_vertices; ++i) {
-                for (UInteger j=0; j<ndim; ++j) {
-                    face_vertices(i,j) = this->mesh_points(this->mesh_faces(this->listfaces[idir],i),j);
-                }
-            }
-
-            // LOOP OVER SURFACES
-            for (UInteger isurface=0; isurface<this->geometry_surfaces.size(); ++isurface)
-            {
-                // CHECK IF THE MESH POINTS AND GEOMETRY POINTS ARE THE SAME
-                for (auto surf_iter=0; surf_iter<geometry_points_on_surfaces[isurface].rows(); ++surf_iter)
-                {
-                    auto x_surface = this->geometry_points_on_surfaces[isurface](surf_iter,0);
-                    auto y_surface = this->geometry_points_on_surfaces[isurface](surf_iter,1);
-                    auto z_surface = this->geometry_points_on_surfaces[isurface](surf_iter,2);
-                    // CHECK IF THE POINT IS ON THE GEOMETRICAL SURFACE
-                    for (auto ivertex = 0; ivertex<no_face_vertices; ++ivertex) {
-                        if (std::abs(x_surface-face_vertices(ivertex,0)) < projection_precision && \
-                                std::abs(y_surface-face_vertices(ivertex,1)) < projection_precision && \
-                                std::abs(z_surface-face_vertices(ivertex,2)) < projection_precision )
-                        {
-                            // PROJECT THE SURFACE VERTEX INSTEAD OF THE FACE NODE
-                            face_vertices(ivertex,0) = x_surface;
-                            face_vertices(ivertex,1) = y_surface;
-                            face_vertices(ivertex,2) = z_surface;
-                            break;
-                        }
-                    }
-                }
-
-                // GET THE MID-POINT OF THE FACE
-                Eigen::RowVectorR coord_avg = face_vertices.colwise().sum().array()/no_face_vertices;
-
-                // gp_Pnt middle_point(x_avg,y_avg,z_avg);
-                gp_Pnt middle_point(coord_avg[0],coord_avg[1],coord_avg[2]);
-
-                if (activate_bounding_box)
-                {
-                    // CHECK IF THE POINT IS OUTSIDE THE BOUNDING BOX
-                    if (coord_avg[0] < bbox_surfaces(isurface,0) ||
-                        coord_avg[1] < bbox_surfaces(isurface,1) ||
-                        coord_avg[2] < bbox_surfaces(isurface,2) ||
-                        coord_avg[0] > bbox_surfaces(isurface,3) ||
-                        coord_avg[1] > bbox_surfaces(isurface,4) ||
-                        coord_avg[2] > bbox_surfaces(isurface,5)) {
-                        // POINT IS OITSIDE THE BOX, MOVE TO NEXT MESH FACE
-                        continue;
-                    }
-                }
-
-                // VERTEX POINTS
-                std::vector<gp_Pnt> face_gp_vertices(no_face_vertices), edge_mid_points(no_face_vertices);
-                for (auto ivertex = 0; ivertex<no_face_vertices; ++ivertex) {
-                    face_gp_vertices[ivertex] = gp_Pnt(face_vertices(ivertex,0),face_vertices(ivertex,1),face_vertices(ivertex,2));
-                }
-                // MID EDGE POINTS
-                edge_mid_points[no_face_vertices-1] = gp_Pnt(   (face_vertices(0,0) + face_vertices(no_face_vertices-1,0))/2.,
-                                                                (face_vertices(0,1) + face_vertices(no_face_vertices-1,1))/2.,
-                                                                (face_vertices(0,2) + face_vertices(no_face_vertices-1,2))/2.);
-                for (auto ivertex = 0; ivertex<no_face_vertices-1; ++ivertex) {
-                    edge_mid_points[ivertex] = gp_Pnt(   (face_vertices(ivertex,0) + face_vertices(ivertex+1,0))/2.,
-                                                         (face_vertices(ivertex,1) + face_vertices(ivertex+1,1))/2.,
-                                                         (face_vertices(ivertex,2) + face_vertices(ivertex+1,2))/2.);
-                }
-
-                // PROJECT THE NODES ON THE SURFACE AND GET THE NEAREST POINT
-                try
-                {
-                    GeomAPI_ProjectPointOnSurf proj;
-                    proj.Init(middle_point,this->geometry_surfaces[isurface]);
-                    mid_distance = proj.LowerDistance();
-
-                    for (auto ivertex=0; ivertex<no_face_vertices; ++ivertex) {
-                        proj.Init(edge_mid_points[ivertex],this->geometry_surfaces[isurface]);
-                        edge_distances[ivertex] = proj.LowerDistance();
-                    }
-
-                    for (auto ivertex=0; ivertex<no_face_vertices; ++ivertex) {
-                        proj.Init(face_gp_vertices[ivertex],this->geometry_surfaces[isurface]);
-                        vertex_distances[ivertex] = proj.LowerDistance();
-                    }
-                }
-                catch (StdFail_NotDone)
-                {
-                    // StdFail_NotDone ISSUE - DO NOTHING
-                }
-                if (mid_distance < min_mid_distance)
-                {
-                    // STORE ID OF SURFACES
-                    this->projection_ID(idir,0) = isurface;
-                    // RE-ASSIGN
-                    min_mid_distance = mid_distance;
-                }
-
-                for (auto ivertex=0; ivertex<no_face_vertices; ++ivertex) {
-                    if (edge_distances[ivertex] < min_edge_distances[ivertex])
-                    {
-                        // STORE ID OF SURFACES
-                        this->projection_ID(idir,ivertex+1) = isurface;
-                        // RE-ASSIGN
-                        min_edge_distances[ivertex] = edge_distances[ivertex];
-                    }
-                }
+    this->projection_ID = Eigen::MatrixIndexI::Zero(this->dirichlet_faces.rows(),no_entities_projected);
 
-                for (auto ivertex=0; ivertex<no_face_vertices; ++ivertex) {
-                    if (vertex_distances[ivertex] < min_vertex_distances[ivertex])
-                    {
-                        // STORE ID OF SURFACES
-                        this->projection_ID(idir,ivertex+no_face_vertices+1) = isurface;
-                        // RE-ASSIGN
-                        min_vertex_distances[ivertex] = vertex_distances[ivertex];
-                    }
-                }
-            }
-        }
-    }
+    if (no_face_vertices==3)
+        this->IdentifyRemainingSurfacesByProjectionKernel<3>(activate_bounding_box);
+    else
+        this->IdentifyRemainingSurfacesByProjectionKernel<4>(activate_bounding_box);
 
     // BASED ON FOUR PROJECTIONS DECIDE WHICH FACE IS ON WHICH SURFACE
     if (this->mesh_element_type == "tet") {
@@ -533,7 +471,7 @@ void PostMeshSurface::IdentifyRemainingSurfacesByProjection(Integer activate_bou
                 // FOR THE GENERAL CASE WE WILL CONSIDER THE MAJORITY
                 // THAT IS ON WHICH SURFACE ARE THE MAJORITY OF THE POINTS LYING
                 Integer max_occurences_idx;
-                Eigen::Matrix<Integer,DYNAMIC,1> current_proj_ids = this->projection_ID.row(i).transpose();
+                Eigen::Matrix<Integer,DYNAMIC,1> current_proj_ids = this->projection_ID.row(i).transpose().cast<Integer>();
                 auto freqs = cnp::itemfreq(current_proj_ids);
                 freqs.col(1).maxCoeff(&max_occurences_idx);
                 this->dirichlet_faces(i,no_face_vertices) = freqs(max_occurences_idx,0);
@@ -542,133 +480,138 @@ void PostMeshSurface::IdentifyRemainingSurfacesByProjection(Integer activate_bou
     }
 }
 
-void PostMeshSurface::IdentifySurfacesContainingFacesByPureProjection(Integer activate_bounding_box, Real bb_tolerance)
+template<Integer NV>
+void PostMeshSurface::IdentifyRemainingSurfacesByProjectionKernel(Integer activate_bounding_box)
 {
-    //! IDENTIFY GEOMETRICAL SURFACES CONTAINING MESH FACES
-    const Integer no_face_vertices = this->GetNoFaceVertices();
-    this->dirichlet_faces = Eigen::MatrixI::Zero(this->mesh_faces.rows(),no_face_vertices+1);
-    this->projection_ID = Eigen::MatrixI::Zero(this->mesh_faces.rows(),no_face_vertices+1);
-    this->listfaces.clear();
-
-    if (activate_bounding_box)
-    {
-        this->GetBoundingBoxOnSurfaces(bb_tolerance);
-    }
-
-    auto index_face = 0;
-
-    // CREATE THE OBJECTS ONLY ONCE
+    //! FACE LOOP OF IdentifyRemainingSurfacesByProjection
     GeomAPI_ProjectPointOnSurf proj;
-    // IN 3D A MID-POINT IS NOT ENOUGH TO DECIDE WHICH MESH FACE IS ON WHICH SURFACE
-    // HENCE WE PROJECT THE MIDDLE POINT OF EVERY EDGE, THE REASON BEING THAT IF TWO
-    // EDGES OF A FACE IS ON A SURFACE THAN THE FACE IS ON THE SURFACE
-    // gp_Pnt middle_point, edge_point_1, edge_point_2, edge_point_3;
-    gp_Pnt middle_point;
+    FaceVertices<NV> face_vertices;
+    std::array<gp_Pnt,NV> face_gp_vertices, edge_mid_points;
+    std::array<Real,NV> min_vertex_distances, vertex_distances, min_edge_distances, edge_distances;
 
     // LOOP OVER DIRCHLET FACES
-    for (auto iface=0; iface<this->mesh_faces.rows(); ++iface)
+    for (Integer idir=0; idir<this->dirichlet_faces.rows(); ++idir)
     {
         // MESH FACES THAT COULD NOT BE DETERMINED
-        if (this->projection_criteria(iface)==1)
+        if (this->dirichlet_faces(idir,NV)==-1)
         {
-            // A LIST OF PROJECTION FACES
-            this->listfaces.push_back(iface);
-            // FILL DIRICHLET DATA
-            for (auto iter=0;iter<no_face_vertices;++iter)
-            {
-               this->dirichlet_faces(index_face,iter) = this->mesh_faces(iface,iter);
-            }
-
             // PROJECT IT OVER ALL SURFACES
             auto min_mid_distance = 1.0e20;
             auto mid_distance = 1.0e10;
 
-            std::vector<Real> min_edge_distances(no_face_vertices,1.0e20);
-            std::vector<Real> edge_distances(no_face_vertices,1.0e10);
+            min_vertex_distances.fill(1.0e20);
+            vertex_distances.fill(1.0e10);
+            min_edge_distances.fill(1.0e20);
+            edge_distances.fill(1.0e10);
 
             // GET THE COORDINATES OF THE FACE VERTICES
-            Eigen::MatrixR face_vertices(no_face_vertices,ndim);
-            for (auto i=0; i<no_face_vertices; ++i) {
-                for (UInteger j=0; j<ndim; ++j) {
-                    face_vertices(i,j) = this->mesh_points(this->mesh_faces(iface,i),j);
-                }
-            }
-
-            // GET THE MID-POINT OF THE FACE
-            Eigen::RowVectorR coord_avg = face_vertices.colwise().sum().array()/no_face_vertices;
-
-            // UPDATE POINTS
-            middle_point.SetX(coord_avg[0]); middle_point.SetY(coord_avg[1]); middle_point.SetZ(coord_avg[2]);
-
-            std::vector<gp_Pnt> edge_mid_points(no_face_vertices);
-            edge_mid_points[no_face_vertices-1] = gp_Pnt(   (face_vertices(0,0) + face_vertices(no_face_vertices-1,0))/2.,
-                                                            (face_vertices(0,1) + face_vertices(no_face_vertices-1,1))/2.,
-                                                            (face_vertices(0,2) + face_vertices(no_face_vertices-1,2))/2.);
-            for (auto ivertex = 0; ivertex<no_face_vertices-1; ++ivertex) {
-                edge_mid_points[ivertex] = gp_Pnt(   (face_vertices(ivertex,0) + face_vertices(ivertex+1,0))/2.,
-                                                     (face_vertices(ivertex,1) + face_vertices(ivertex+1,1))/2.,
-                                                     (face_vertices(ivertex,2) + face_vertices(ivertex+1,2))/2.);
-            }
+            GatherFaceVertices<NV>(this->mesh_points,this->mesh_faces,this->listfaces[idir],face_vertices);
 
             // LOOP OVER SURFACES
             for (UInteger isurface=0; isurface<this->geometry_surfaces.size(); ++isurface)
             {
+                // CHECK IF THE MESH POINTS AND GEOMETRY POINTS ARE THE SAME
+                SnapToSurfacePoints<NV>(this->geometry_points_on_surfaces[isurface],this->projection_precision,face_vertices);
+
+                // GET THE MID-POINT OF THE FACE
+                const FacePoint coord_avg = face_vertices.colwise().sum()/Real(NV);
+
+                gp_Pnt middle_point(coord_avg[0],coord_avg[1],coord_avg[2]);
+
                 if (activate_bounding_box)
                 {
                     // CHECK IF THE POINT IS OUTSIDE THE BOUNDING BOX
-                    if (coord_avg[0] < bbox_surfaces(isurface,0) ||
-                        coord_avg[1] < bbox_surfaces(isurface,1) ||
-                        coord_avg[2] < bbox_surfaces(isurface,2) ||
-                        coord_avg[0] > bbox_surfaces(isurface,3) ||
-                        coord_avg[1] > bbox_surfaces(isurface,4) ||
-                        coord_avg[2] > bbox_surfaces(isurface,5)) {
+                    if (!this->InBoundingBox(isurface,coord_avg)) {
                         // POINT IS OITSIDE THE BOX, MOVE TO NEXT MESH FACE
                         continue;
                     }
                 }
+
+                // VERTEX AND MID EDGE POINTS
+                FaceGpPoints<NV>(face_vertices,face_gp_vertices,edge_mid_points);
+
                 // PROJECT THE NODES ON THE SURFACE AND GET THE NEAREST POINT
+                SurfaceCost &cost = this->stats.Surface(isurface);
                 try
                 {
+                    PostMeshTimer timer(cost.identification_time);
+                    ++this->stats.projections_on_surface;
+                    ++cost.projections;
                     proj.Init(middle_point,this->geometry_surfaces[isurface]);
                     mid_distance = proj.LowerDistance();
 
-                    for (auto ivertex=0; ivertex<no_face_vertices; ++ivertex) {
+                    for (Integer ivertex=0; ivertex<NV; ++ivertex) {
+                        ++this->stats.projections_on_surface;
+                        ++cost.projections;
                         proj.Init(edge_mid_points[ivertex],this->geometry_surfaces[isurface]);
                         edge_distances[ivertex] = proj.LowerDistance();
                     }
+
+                    for (Integer ivertex=0; ivertex<NV; ++ivertex) {
+                        ++this->stats.projections_on_surface;
+                        ++cost.projections;
+                        proj.Init(face_gp_vertices[ivertex],this->geometry_surfaces[isurface]);
+                        vertex_distances[ivertex] = proj.LowerDistance();
+                    }
                 }
                 catch (StdFail_NotDone)
                 {
-                    // StdFail_NotDone ISSUE - DO NOTHING
+                    ++this->stats.projection_failures;
+                    ++cost.failures;
                 }
                 if (mid_distance < min_mid_distance)
                 {
                     // STORE ID OF SURFACES
-                    this->projection_ID(index_face,0) = isurface;
+                    this->projection_ID(idir,0) = isurface;
                     // RE-ASSIGN
                     min_mid_distance = mid_distance;
                 }
 
-                for (auto ivertex=0; ivertex<no_face_vertices; ++ivertex) {
+                for (Integer ivertex=0; ivertex<NV; ++ivertex) {
                     if (edge_distances[ivertex] < min_edge_distances[ivertex])
                     {
                         // STORE ID OF SURFACES
-                        this->projection_ID(index_face,ivertex+1) = isurface;
+                        this->projection_ID(idir,ivertex+1) = isurface;
                         // RE-ASSIGN
                         min_edge_distances[ivertex] = edge_distances[ivertex];
                     }
                 }
+
+                for (Integer ivertex=0; ivertex<NV; ++ivertex) {
+                    if (vertex_distances[ivertex] < min_vertex_distances[ivertex])
+                    {
+                        // STORE ID OF SURFACES
+                        this->projection_ID(idir,ivertex+NV+1) = isurface;
+                        // RE-ASSIGN
+                        min_vertex_distances[ivertex] = vertex_distances[ivertex];
+                    }
+                }
             }
-            index_face +=1;
         }
     }
+}
+
+void PostMeshSurface::IdentifySurfacesContainingFacesByPureProjection(Integer activate_bounding_box, Real bb_tolerance)
+{
+    PostMeshPhase phase(this->stats,"IdentifySurfacesContainingFacesByPureProjection");
+    //! IDENTIFY GEOMETRICAL SURFACES CONTAINING MESH FACES
+    const Integer no_face_vertices = this->GetNoFaceVertices();
+    this->dirichlet_faces = Eigen::MatrixIndexI::Zero(this->mesh_faces.rows(),no_face_vertices+1);
+    this->projection_ID = Eigen::MatrixIndexI::Zero(this->mesh_faces.rows(),no_face_vertices+1);
+    this->listfaces.clear();
+
+    if (activate_bounding_box)
+    {
+        this->GetBoundingBoxOnSurfaces(bb_tolerance);
+    }
+
+    const Integer index_face = no_face_vertices==3 ?
+        this->IdentifySurfacesContainingFacesByPureProjectionKernel<3>(activate_bounding_box) :
+        this->IdentifySurfacesContainingFacesByPureProjectionKernel<4>(activate_bounding_box);
 
     // REDUCE THE MATRIX TO GET DIRICHLET FACES
-    auto arr_rows = cnp::arange(static_cast<Integer>(index_face));
-    auto arr_cols = cnp::arange(no_face_vertices+1);
-    this->dirichlet_faces = cnp::take(this->dirichlet_faces,arr_rows,arr_cols);
-    arr_cols = cnp::arange(no_face_vertices+1);
-    this->projection_ID = cnp::take(this->projection_ID,arr_rows,arr_cols);
+    this->dirichlet_faces.conservativeResize(index_face,Eigen::NoChange);
+    this->projection_ID.conservativeResize(index_face,Eigen::NoChange);
 
     // BASED ON FOUR PROJECTIONS DECIDE WHICH FACE IS ON WHICH SURFACE
     if (this->mesh_element_type == "tet") {
@@ -731,8 +674,115 @@ void PostMeshSurface::IdentifySurfacesContainingFacesByPureProjection(Integer ac
     }
 }
 
+template<Integer NV>
+Integer PostMeshSurface::IdentifySurfacesContainingFacesByPureProjectionKernel(Integer activate_bounding_box)
+{
+    //! FACE LOOP OF IdentifySurfacesContainingFacesByPureProjection. RETURNS
+    //! THE NUMBER OF FACES TO BE PROJECTED
+    Integer index_face = 0;
+
+    // CREATE THE OBJECTS ONLY ONCE
+    GeomAPI_ProjectPointOnSurf proj;
+    // IN 3D A MID-POINT IS NOT ENOUGH TO DECIDE WHICH MESH FACE IS ON WHICH SURFACE
+    // HENCE WE PROJECT THE MIDDLE POINT OF EVERY EDGE, THE REASON BEING THAT IF TWO
+    // EDGES OF A FACE IS ON A SURFACE THAN THE FACE IS ON THE SURFACE
+    gp_Pnt middle_point;
+    FaceVertices<NV> face_vertices;
+    std::array<gp_Pnt,NV> face_gp_vertices, edge_mid_points;
+    std::array<Real,NV> min_edge_distances, edge_distances;
+
+    // LOOP OVER DIRCHLET FACES
+    for (Integer iface=0; iface<this->mesh_faces.rows(); ++iface)
+    {
+        // MESH FACES THAT COULD NOT BE DETERMINED
+        if (this->projection_criteria(iface)==1)
+        {
+            // A LIST OF PROJECTION FACES
+            this->listfaces.push_back(iface);
+            // FILL DIRICHLET DATA
+            for (Integer iter=0; iter<NV; ++iter)
+            {
+               this->dirichlet_faces(index_face,iter) = this->mesh_faces(iface,iter);
+            }
+
+            // PROJECT IT OVER ALL SURFACES
+            auto min_mid_distance = 1.0e20;
+            auto mid_distance = 1.0e10;
+
+            min_edge_distances.fill(1.0e20);
+            edge_distances.fill(1.0e10);
+
+            // GET THE COORDINATES OF THE FACE VERTICES
+            GatherFaceVertices<NV>(this->mesh_points,this->mesh_faces,iface,face_vertices);
+
+            // GET THE MID-POINT OF THE FACE
+            const FacePoint coord_avg = face_vertices.colwise().sum()/Real(NV);
+
+            // UPDATE POINTS
+            middle_point.SetX(coord_avg[0]); middle_point.SetY(coord_avg[1]); middle_point.SetZ(coord_avg[2]);
+
+            FaceGpPoints<NV>(face_vertices,face_gp_vertices,edge_mid_points);
+
+            // LOOP OVER SURFACES
+            for (UInteger isurface=0; isurface<this->geometry_surfaces.size(); ++isurface)
+            {
+                if (activate_bounding_box)
+                {
+                    // CHECK IF THE POINT IS OUTSIDE THE BOUNDING BOX
+                    if (!this->InBoundingBox(isurface,coord_avg)) {
+                        // POINT IS OITSIDE THE BOX, MOVE TO NEXT MESH FACE
+                        continue;
+                    }
+                }
+                // PROJECT THE NODES ON THE SURFACE AND GET THE NEAREST POINT
+                SurfaceCost &cost = this->stats.Surface(isurface);
+                try
+                {
+                    PostMeshTimer timer(cost.identification_time);
+                    ++this->stats.projections_on_surface;
+                    ++cost.projections;
+                    proj.Init(middle_point,this->geometry_surfaces[isurface]);
+                    mid_distance = proj.LowerDistance();
+
+                    for (Integer ivertex=0; ivertex<NV; ++ivertex) {
+                        ++this->stats.projections_on_surface;
+                        ++cost.projections;
+                        proj.Init(edge_mid_points[ivertex],this->geometry_surfaces[isurface]);
+                        edge_distances[ivertex] = proj.LowerDistance();
+                    }
+                }
+                catch (StdFail_NotDone)
+                {
+                    ++this->stats.projection_failures;
+                    ++cost.failures;
+                }
+                if (mid_distance < min_mid_distance)
+                {
+                    // STORE ID OF SURFACES
+                    this->projection_ID(index_face,0) = isurface;
+                    // RE-ASSIGN
+                    min_mid_distance = mid_distance;
+                }
+
+                for (Integer ivertex=0; ivertex<NV; ++ivertex) {
+                    if (edge_distances[ivertex] < min_edge_distances[ivertex])
+                    {
+                        // STORE ID OF SURFACES
+                        this->projection_ID(index_face,ivertex+1) = isurface;
+                        // RE-ASSIGN
+                        min_edge_distances[ivertex] = edge_distances[ivertex];
+                    }
+                }
+            }
+            index_face +=1;
+        }
+    }
+    return index_face;
+}
+
 void PostMeshSurface::SupplySurfacesContainingFaces(const Integer *arr, Integer rows, Integer already_mapped, Integer caller)
 {
+    PostMeshPhase phase(this->stats,"SupplySurfacesContainingFaces",&this->diagnostics);
     //! IN SOME EXTREME CASES OPENCASCADE MIGHT FAIL TO IDENTIFY THE RIGHT GEOMETRICAL
     //! SURFACE TO PROJECT THE MESH FACE TO. IN SUCH CASES IT IS CONVENIENT TO SUPPLY
     //! THIS INFORMATION FROM AN EXTERNAL MESH GENERATOR (E.G. GID, GMSH ETC).
@@ -742,7 +792,7 @@ void PostMeshSurface::SupplySurfacesContainingFaces(const Integer *arr, Integer
     //! ARE DIFFERENT. FOR SUCH CASES SUPPLY ALREADY_MAPPED FLAG AS ZERO
 
     const Integer no_face_vertices = this->GetNoFaceVertices();
-    Eigen::MatrixI dirichlet_faces_ext = Eigen::MatrixI::Constant(rows,no_face_vertices+1,-1);
+    Eigen::MatrixIndexI dirichlet_faces_ext = Eigen::MatrixIndexI::Constant(rows,no_face_vertices+1,-1);
     this->listfaces.clear();
     auto index_face = 0;
     // LOOP OVER FACES
@@ -771,9 +821,7 @@ void PostMeshSurface::SupplySurfacesContainingFaces(const Integer *arr, Integer
         // ALREADY-MAPPED ESSENTIALLY MEANS THAT THE EXTERNAL GEOMETRICAL SURFACE
         // NUMBERING IS THE SAME AS OPENCASCADE'S
         // REDUCE THE MATRIX TO GET DIRICHLET FACES
-        auto arr_rows = cnp::arange(static_cast<Integer>(index_face));
-        auto arr_cols = cnp::arange(no_face_vertices+1);
-        this->dirichlet_faces = cnp::take(dirichlet_faces_ext,arr_rows,arr_cols);
+        this->dirichlet_faces = dirichlet_faces_ext.topRows(index_face);
         return;
     }
 
@@ -790,20 +838,23 @@ void PostMeshSurface::SupplySurfacesContainingFaces(const Integer *arr, Integer
         this->IdentifySurfacesContainingFacesByPureProjection();
     }
 
-    const Eigen::MatrixI surface_flags_ext = Eigen::Map<const Eigen::MatrixI>(arr,rows,1);
-    std::vector<Integer> unique_surface_flags_ext;
-    std::tie(unique_surface_flags_ext,std::ignore) = cnp::unique(surface_flags_ext);
+    // GROUP THE FACES BY EXTERNAL SURFACE FLAG WITH ONE STABLE SORT, SO THAT
+    // THE ROWS OF EVERY GROUP STAY IN ASCENDING ORDER
+    const std::vector<Integer> sorter = cnp::stable_argsort(arr,rows);
+    Eigen::MatrixUI col(1,1); col(0,0) = no_face_vertices;
 
-    for (auto &k: unique_surface_flags_ext)
+    for (Integer start=0, stop=0; start<rows; start=stop)
     {
-        Eigen::MatrixUI urows;
-        std::tie(urows,std::ignore) = cnp::where_eq(surface_flags_ext,k);
-        Eigen::MatrixUI col(1,1); col(0,0) = no_face_vertices;
+        stop = start+1;
+        while (stop<rows && arr[sorter[stop]]==arr[sorter[start]]) ++stop;
+        Eigen::MatrixUI urows(stop-start,1);
+        for (Integer i=start; i<stop; ++i)
+            urows(i-start) = sorter[i];
 
         //! FIND THE ROWS OF INTERNAL BASED ON EXTRENAL. GET ITEMFREQ OF THESE ROWS
         //! GET THE MAXIMUM OCCURENCE FROM ITEMFREQ AND CHANGE THE REMAINING
         //! INTERNAL ROWS BASED ON THAT
-        Eigen::MatrixI flags_int = cnp::take(this->dirichlet_faces,urows,col);
+        Eigen::MatrixIndexI flags_int = cnp::take(this->dirichlet_faces,urows,col);
         auto freqs_int = cnp::itemfreq(flags_int);
         if (freqs_int.rows()==1)
         {
@@ -811,17 +862,18 @@ void PostMeshSurface::SupplySurfacesContainingFaces(const Integer *arr, Integer
         }
         else
         {
-            Eigen::MatrixI col_1_flags_int = freqs_int.col(1);
+            Eigen::MatrixIndexI col_1_flags_int = freqs_int.col(1);
             auto nmax = col_1_flags_int.maxCoeff();
             Eigen::MatrixUI encounters;
             std::tie(encounters,std::ignore) = cnp::where_eq(col_1_flags_int,nmax);
             if (encounters.rows()==1)
             {
-                cnp::put(dirichlet_faces_ext,freqs_int(encounters(nmax,0),0),urows,col);
+                cnp::put(dirichlet_faces_ext,freqs_int(encounters(0,0),0),urows,col);
             }
             else
             {
-                warn("Surface detection failed. Mesh faces are getting projected to incorrect surfaces");
+                ++this->stats.unresolved_faces;
+                this->diagnostics.Report(SEVERITY_WARNING,"Surface detection failed. Mesh faces are getting projected to incorrect surfaces");
             }
         }
     }
@@ -829,71 +881,94 @@ void PostMeshSurface::SupplySurfacesContainingFaces(const Integer *arr, Integer
     this->dirichlet_faces = dirichlet_faces_ext;
 }
 
+template<typename Key>
+static void SurfaceChangingEdges(const std::vector<Key> &keys, const std::vector<Integer> &edges_surface_flag,
+                                 Integer no_dir_faces, std::vector<Integer> &faces, std::vector<Integer> &local_edges)
+{
+    //! RADIX SORT THE EDGE KEYS SO THAT COPIES OF AN EDGE SHARED BY TWO FACES
+    //! ARE ADJACENT AND RECORD THE FACE AND LOCAL EDGE OF BOTH COPIES WHEN THE
+    //! FACES LIE ON DIFFERENT SURFACES
+    const Integer no_edges = keys.size();
+    const std::vector<Integer> order = cnp::radix_argsort(keys);
+    for (Integer k=0; k+1<no_edges; ++k)
+    {
+        const Integer i = order[k];
+        const Integer j = order[k+1];
+        if (keys[i]==keys[j] && edges_surface_flag[i] != edges_surface_flag[j])
+        {
+            faces.push_back(i % no_dir_faces);
+            faces.push_back(j % no_dir_faces);
+
+            local_edges.push_back(i / no_dir_faces);
+            local_edges.push_back(j / no_dir_faces);
+        }
+    }
+}
+
 void PostMeshSurface::IdentifySurfacesIntersections()
 {
+    PostMeshPhase phase(this->stats,"IdentifySurfacesIntersections");
     //! THIS METHOD CHECKS IF THERE ARE EDGES WHICH ARE SHARED BETWEEN TWO FACES
     //! WITH EACH OF THOSE FACES BEING PROJECTED ON TO DIFFERENT SURFACES
 
 
-    // BUILD EDGES FIRST
+    // LOCAL EDGES OF A BOUNDARY FACE
+    std::vector<std::array<Integer,2>> local_edges;
+    if (this->mesh_element_type == "tet")
+        local_edges = {{{0,1}},{{0,2}},{{1,2}}};
+    else if (this->mesh_element_type == "hex")
+        local_edges = {{{0,1}},{{1,2}},{{2,3}},{{3,0}}};
+
+    // EDGE i+l*no_dir_faces IS LOCAL EDGE l OF FACE i. EVERY EDGE IS KEYED BY
+    // ITS SORTED VERTEX NUMBERS PACKED INTO 64 BITS, OR 128 BITS IF THE NODE
+    // NUMBERS ARE TOO WIDE, AND CARRIES THE SURFACE FLAG OF ITS FACE
     const Integer no_dir_faces = this->dirichlet_faces.rows();
     const Integer no_face_vertices = this->GetNoFaceVertices();
-    const Integer no_edges = no_face_vertices*no_dir_faces;
-    std::vector<std::vector<Integer>> edges(no_edges);
+    const Integer no_edges = local_edges.size()*no_dir_faces;
     std::vector<Integer> edges_surface_flag(no_edges);
 
-    if (this->mesh_element_type == "tet") {
-        for (auto i=0; i<no_dir_faces; ++i)
-        {
-            edges[i]                = {this->dirichlet_faces(i,0),this->dirichlet_faces(i,1)};
-            edges[i+no_dir_faces]   = {this->dirichlet_faces(i,0),this->dirichlet_faces(i,2)};
-            edges[i+2*no_dir_faces] = {this->dirichlet_faces(i,1),this->dirichlet_faces(i,2)};
-
-            const auto surface_flag = this->dirichlet_faces(i,no_face_vertices);
-            edges_surface_flag[i]                   = surface_flag;
-            edges_surface_flag[i+no_dir_faces]      = surface_flag;
-            edges_surface_flag[i+2*no_dir_faces]    = surface_flag;
-        }
-    }
-    else if (this->mesh_element_type == "hex") {
-        for (auto i=0; i<no_dir_faces; ++i)
-        {
-            edges[i]                = {this->dirichlet_faces(i,0),this->dirichlet_faces(i,1)};
-            edges[i+no_dir_faces]   = {this->dirichlet_faces(i,1),this->dirichlet_faces(i,2)};
-            edges[i+2*no_dir_faces] = {this->dirichlet_faces(i,2),this->dirichlet_faces(i,3)};
-            edges[i+3*no_dir_faces] = {this->dirichlet_faces(i,3),this->dirichlet_faces(i,0)};
-
-            const auto surface_flag = this->dirichlet_faces(i,no_face_vertices);
-            edges_surface_flag[i]                   = surface_flag;
-            edges_surface_flag[i+no_dir_faces]      = surface_flag;
-            edges_surface_flag[i+2*no_dir_faces]    = surface_flag;
-            edges_surface_flag[i+3*no_dir_faces]    = surface_flag;
-        }
+    Integer bits = 1;
+    if (no_edges)
+    {
+        const Integer max_node = this->dirichlet_faces.leftCols(no_face_vertices).maxCoeff();
+        while (bits<64 && (max_node >> bits) != 0) ++bits;
     }
 
-    // SORT ROWS - ONY THE FIRST TWO ELEMENTS
-    cnp::sort_rows(edges);
-    std::vector<Integer> idx = cnp::argsort(edges);
-    std::vector<Integer> invidx = cnp::argsort(idx);
+    auto edge_vertices = [&](Integer e, std::uint64_t &v0, std::uint64_t &v1) {
+        const Integer i = e % no_dir_faces;
+        const std::array<Integer,2> &local = local_edges[e / no_dir_faces];
+        v0 = this->dirichlet_faces(i,local[0]);
+        v1 = this->dirichlet_faces(i,local[1]);
+        if (v1 < v0) std::swap(v0,v1);
+        edges_surface_flag[e] = this->dirichlet_faces(i,no_face_vertices);
+    };
 
     std::vector<Integer> faces_with_curve_projection_edges_0;
     std::vector<Integer> faces_with_curve_projection_edges_1;
-    faces_with_curve_projection_edges_0.reserve(no_edges);
-    faces_with_curve_projection_edges_1.reserve(no_edges);
 
-    for (auto k=0; k<no_edges;++k)
+    if (2*bits <= 64)
     {
-        if (invidx[k] == no_edges-1) continue;
-        const Integer i = idx[invidx[k]];
-        const Integer j = idx[invidx[k]+1];
-        if ( edges[i][0]==edges[j][0] && edges[i][1]==edges[j][1] && edges_surface_flag[i] != edges_surface_flag[j] )
-        {
-            faces_with_curve_projection_edges_0.push_back(i % no_dir_faces);
-            faces_with_curve_projection_edges_0.push_back(j % no_dir_faces);
-
-            faces_with_curve_projection_edges_1.push_back(i / no_dir_faces);
-            faces_with_curve_projection_edges_1.push_back(j / no_dir_faces);
-        }
+        std::vector<std::uint64_t> keys(no_edges);
+        parallel_for(0,no_edges,[&](Integer lo, Integer hi) {
+            for (Integer e=lo; e<hi; ++e)
+            {
+                std::uint64_t v0, v1;
+                edge_vertices(e,v0,v1);
+                keys[e] = (v0 << bits) | v1;
+            }
+        }, 4096);
+        SurfaceChangingEdges(keys,edges_surface_flag,no_dir_faces,
+                             faces_with_curve_projection_edges_0,faces_with_curve_projection_edges_1);
+    }
+    else
+    {
+        std::vector<cnp::uint128_key> keys(no_edges);
+        parallel_for(0,no_edges,[&](Integer lo, Integer hi) {
+            for (Integer e=lo; e<hi; ++e)
+                edge_vertices(e,keys[e].hi,keys[e].lo);
+        }, 4096);
+        SurfaceChangingEdges(keys,edges_surface_flag,no_dir_faces,
+                             faces_with_curve_projection_edges_0,faces_with_curve_projection_edges_1);
     }
 
     this->GetBoundaryPointsOrder();
@@ -912,17 +987,33 @@ void PostMeshSurface::IdentifySurfacesIntersections()
 
 void PostMeshSurface::ProjectMeshOnSurface()
 {
+    PostMeshPhase phase(this->stats,"ProjectMeshOnSurface",&this->diagnostics);
+    // MESH POINTS ARE MODIFIED IN PLACE
+    this->mesh_points.MakeWritable();
     // CONVENIENCE FUNCTION FOR SIMILARITY WITH 2D (USEFUL FOR REPAIRING DUAL IMAGES)
     const Integer no_face_vertices = this->GetNoFaceVertices();
     this->InferInterpolationPolynomialDegree();
-    this->projection_U = Eigen::MatrixR::Zero(this->dirichlet_faces.rows(),this->ndim);
-    this->projection_V = Eigen::MatrixR::Zero(this->dirichlet_faces.rows(),this->ndim);
+    this->projection_U = Eigen::MatrixR::Zero(this->dirichlet_faces.rows(),no_face_vertices);
+    this->projection_V = Eigen::MatrixR::Zero(this->dirichlet_faces.rows(),no_face_vertices);
+
+    if (no_face_vertices==3)
+        this->ProjectMeshOnSurfaceKernel<3>();
+    else
+        this->ProjectMeshOnSurfaceKernel<4>();
+}
 
+template<Integer NV>
+void PostMeshSurface::ProjectMeshOnSurfaceKernel()
+{
     // LOOP OVER EDGES
     for (auto idir=0; idir<this->dirichlet_faces.rows(); ++idir)
     {
-        // LOOP OVER THE THREE VERTICES OF THE FACE
-        for (Integer inode=0; inode<no_face_vertices; ++inode)
+        // GET THE SURFACE THAT THIS FACE HAS TO BE PROJECTED TO
+        const auto isurface = this->dirichlet_faces(idir,NV);
+        const Handle_Geom_Surface &current_surface = this->geometry_surfaces[isurface];
+
+        // LOOP OVER THE VERTICES OF THE FACE
+        for (Integer inode=0; inode<NV; ++inode)
         {
             // PROJECTION PARAMETERS
             Real parameterU, parameterV;
@@ -931,9 +1022,6 @@ void PostMeshSurface::ProjectMeshOnSurface()
             auto y = this->mesh_points(this->mesh_faces(this->listfaces[idir],inode),1);
             auto z = this->mesh_points(this->mesh_faces(this->listfaces[idir],inode),2);
 
-            // GET THE SURFACE THAT THIS FACE HAS TO BE PROJECTED TO
-            auto isurface = this->dirichlet_faces(idir,no_face_vertices);
-            Handle_Geom_Surface current_surface = this->geometry_surfaces[isurface];
             // GET THE COORDINATES OF SURFACE'S THREE VERTICES
             Real x_surface, y_surface, z_surface;
             for (auto surf_iter=0; surf_iter<geometry_points_on_surfaces[isurface].rows(); ++surf_iter)
@@ -951,24 +1039,33 @@ void PostMeshSurface::ProjectMeshOnSurface()
                     x = x_surface;
                     y = y_surface;
                     z = z_surface;
+                    ++this->stats.vertex_snaps;
                 }
             }
 
             auto xEq = gp_Pnt(x,y,z);
+            // GET THE NODE THAT HAS TO BE PROJECTED TO THE CURVE
+            auto node_to_be_projected = gp_Pnt(x,y,z);
+            SurfaceCost &cost = this->stats.Surface(isurface);
             try
             {
-                // GET THE NODE THAT HAS TO BE PROJECTED TO THE CURVE
-                auto node_to_be_projected = gp_Pnt(x,y,z);
+                PostMeshTimer timer(cost.projection_time);
                 // PROJECT THE NODES ON THE CURVE AND GET THE PARAMETER U
                 GeomAPI_ProjectPointOnSurf proj;
+                ++this->stats.projections_on_surface;
+                ++cost.projections;
                 proj.Init(node_to_be_projected,current_surface);
                 proj.LowerDistanceParameters(parameterU,parameterV);
                 current_surface->D0(parameterU,parameterV,xEq);
             }
             catch (StdFail_NotDone)
             {
-                warn("The face node was not projected on to the right surface. Surface number: ",isurface);
+                ++this->stats.projection_failures;
+                ++cost.failures;
+                this->diagnostics.Report(SEVERITY_WARNING,"The face node was not projected on to the right surface",
+                    "Surface number:",isurface);
             }
+            cost.worst_residual = std::max(cost.worst_residual,node_to_be_projected.Distance(xEq)/this->scale);
 
             // UPDATE THE MESH POINTS TO CONFORM TO CAD GEOMETRY - NOT TO SCALE
             this->mesh_points(this->mesh_faces(this->listfaces[idir],inode),0) = xEq.X();
@@ -984,6 +1081,7 @@ void PostMeshSurface::ProjectMeshOnSurface()
 
 void PostMeshSurface::RepairDualProjectedParameters()
 {
+    PostMeshPhase phase(this->stats,"RepairDualProjectedParameters");
     // SORT PROJECTED PARAMETERS OF EACH EDGE - MUST INITIALISE SORT INDICES
     const Integer no_face_vertices = this->GetNoFaceVertices();
     this->sorted_projected_indicesU.setZero(this->projection_U.rows(),this->projection_U.cols());
@@ -1066,22 +1164,23 @@ void PostMeshSurface::MeshPointInversionCurve(const gp_Pnt &point_in, gp_Pnt &po
 {
     auto min_distance = 1.0e20;
     auto distance = 1.0e10;
+    GeomAPI_ProjectPointOnCurve proj;
 
     if (id_surface != -1) {
 
         // GET THE CURVES OF THE CURRENT SURFACE
-        std::vector<Handle_Geom_Curve> current_surface_curves = this->geometry_surfaces_curves[id_surface];
-        std::vector<UInteger> current_surface_curves_types = this->geometry_surfaces_curves_types[id_surface];
+        const std::vector<Handle_Geom_Curve> &current_surface_curves = this->SurfaceCurves(id_surface);
+        const std::vector<UInteger> &current_surface_curves_types = this->SurfaceCurvesTypes(id_surface);
         // ITERATE OVER THEM
         for (UInteger i=0; i<current_surface_curves.size(); ++i)
         {
-            Handle_Geom_Curve current_curve = current_surface_curves[i];
+            const Handle_Geom_Curve &current_curve = current_surface_curves[i];
             auto current_curve_type = current_surface_curves_types[i];
             if (current_curve_type != GeomAbs_OtherCurve)
             {
                 try
                 {
-                    GeomAPI_ProjectPointOnCurve proj;
+                    ++this->stats.projections_on_curve;
                     proj.Init(point_in,current_curve);
                     distance = proj.LowerDistance();
                     if (distance < min_distance)
@@ -1093,7 +1192,7 @@ void PostMeshSurface::MeshPointInversionCurve(const gp_Pnt &point_in, gp_Pnt &po
                 }
                 catch (StdFail_NotDone)
                 {
-                    // DO NOTHING
+                    ++this->stats.projection_failures;
                 }
             }
         }
@@ -1104,8 +1203,8 @@ void PostMeshSurface::MeshPointInversionCurve(const gp_Pnt &point_in, gp_Pnt &po
         // HOWEVER THIS WILL WORK ON SITUATIONS WHERE THE FORMER APPROACH MIGHT FAIL
         for (UInteger i=0; i<this->geometry_curves.size(); ++i)
         {
-            Handle_Geom_Curve current_curve = this->geometry_curves[i];
-            auto current_curve_type = this->geometry_curves_types[i];
+            const Handle_Geom_Curve &current_curve = this->geometry_curves[i];
+            auto current_curve_type = this->CurveType(i);
             if (current_curve_type != GeomAbs_OtherCurve)
             {
                 try
@@ -1116,7 +1215,7 @@ void PostMeshSurface::MeshPointInversionCurve(const gp_Pnt &point_in, gp_Pnt &po
                    // auto Newton_precision = projection_precision < 1.0e-05 ? 1.0e-5: projection_precision;
                    // proj_Newton.Project(current_curve,point_in,Newton_precision,point_out,uEq,True);
 
-                    GeomAPI_ProjectPointOnCurve proj;
+                    ++this->stats.projections_on_curve;
                     proj.Init(point_in,current_curve);
                     distance = proj.LowerDistance();
                     if (distance < min_distance)
@@ -1128,7 +1227,7 @@ void PostMeshSurface::MeshPointInversionCurve(const gp_Pnt &point_in, gp_Pnt &po
                 }
                 catch (StdFail_NotDone)
                 {
-                    // DO NOTHING
+                    ++this->stats.projection_failures;
                 }
             }
         }
@@ -1137,16 +1236,16 @@ void PostMeshSurface::MeshPointInversionCurve(const gp_Pnt &point_in, gp_Pnt &po
 
 void PostMeshSurface::MeshPointInversionSurface(Integer project_on_curves, Integer modify_linear_mesh)
 {
+    PostMeshPhase phase(this->stats,"MeshPointInversionSurface",&this->diagnostics);
+    // MESH POINTS ARE MODIFIED IN PLACE
+    this->mesh_points.MakeWritable();
     const Integer no_face_vertices = this->GetNoFaceVertices();
     this->no_dir_faces = this->dirichlet_faces.rows();
     auto no_face_nodes = this->mesh_faces.cols();
-    Eigen::MatrixI arr_row = Eigen::Map<Eigen::Matrix<Integer,Eigen::Dynamic,1> >
-            (this->listfaces.data(),this->listfaces.size());
-    auto arr_col = cnp::arange(no_face_nodes);
-    this->nodes_dir = cnp::take(this->mesh_faces,arr_row,arr_col);
-    this->nodes_dir = cnp::ravel(this->nodes_dir);
-    this->index_nodes = cnp::arange(Integer(no_face_nodes));
+    this->InvalidateDirichletData();
+    this->nodes_dir = cnp::take_rows(this->mesh_faces,this->listfaces,true);
     this->displacements_BC = Eigen::MatrixR::Zero(this->no_dir_faces*no_face_nodes,this->ndim);
+    this->projection_residuals = Eigen::MatrixR::Zero(this->no_dir_faces,1);
 
     if (this->curve_surface_projection_flags.rows() != this->dirichlet_faces.rows())
     {
@@ -1157,12 +1256,17 @@ void PostMeshSurface::MeshPointInversionSurface(Integer project_on_curves, Integ
     if (this->mesh_element_type == "hex") starter = 4;
     if (modify_linear_mesh==1) starter = 0;
 
+    GeomAPI_ProjectPointOnSurf proj;
 
     for (auto idir=0; idir< this->no_dir_faces; ++idir)
     {
         Integer id_surface = this->dirichlet_faces(idir,no_face_vertices);
-        Handle_Geom_Surface current_surface = this->geometry_surfaces[id_surface];
+        const Handle_Geom_Surface &current_surface = this->geometry_surfaces[id_surface];
+        // FIRST ROW OF THE FACE IN nodes_dir AND displacements_BC
+        const Integer node_offset = idir*no_face_nodes;
 
+        // ALL NODES OF THE FACE, WHOSE NUMBER DEPENDS ON THE POLYNOMIAL DEGREE,
+        // SO UNLIKE THE VERTEX KERNELS THIS LOOP IS NOT SPECIALISED ON NV
         for (auto j=starter; j<no_face_nodes;++j)
         {
             auto x = this->mesh_points(this->mesh_faces(this->listfaces[idir],j),0);
@@ -1180,6 +1284,7 @@ void PostMeshSurface::MeshPointInversionSurface(Integer project_on_curves, Integ
                          (std::abs(k.Z() - z ) < this->projection_precision) )
                     {
                         x = k.X(); y = k.Y(); z = k.Z();
+                        ++this->stats.vertex_snaps;
                         break;
                     }
                 }
@@ -1188,39 +1293,51 @@ void PostMeshSurface::MeshPointInversionSurface(Integer project_on_curves, Integ
             Real uEq,vEq;
             // COORDINDATES OF PROJECTED NODE
             auto xEq = gp_Pnt(x,y,z);
-            auto gp_pnt_old = (this->mesh_points.row(this->nodes_dir(this->index_nodes( j ))).array()/this->scale);
+            auto gp_pnt_old = (this->mesh_points.row(this->nodes_dir(node_offset+j)).array()/this->scale);
 
             // MAKE THE POINT
             auto point_to_be_projected = gp_Pnt(x,y,z);
 
             // CHECK IF THE POINT IS SUPPOSED TO BE PROEJECTED TO A CURVE
+            SurfaceCost &cost = this->stats.Surface(id_surface);
             if (this->curve_surface_projection_flags(idir,j) == 1 && project_on_curves == 1)
             {
+                PostMeshTimer timer(cost.inversion_time);
+                ++cost.projections;
                 this->MeshPointInversionCurve(point_to_be_projected, xEq, id_surface);
             }
             else
             {
                 try
                 {
-                    GeomAPI_ProjectPointOnSurf proj;
+                    PostMeshTimer timer(cost.inversion_time);
+                    ++this->stats.projections_on_surface;
+                    ++cost.projections;
                     proj.Init(point_to_be_projected,current_surface,1e-06,Extrema_ExtAlgo_Grad);
                     proj.LowerDistanceParameters(uEq,vEq);
                     current_surface->D0(uEq,vEq,xEq);
                 }
                 catch (StdFail_NotDone)
                 {
-                    warn("Could not project node to the right surface. "
-                         "Surface ID is:", id_surface, "  Surface type is:", this->geometry_surfaces_types[id_surface],
-                         "  Node number is:", this->mesh_faces(this->listfaces[idir],j));
+                    ++this->stats.projection_failures;
+                    ++cost.failures;
+                    this->diagnostics.Report(SEVERITY_WARNING,"Could not project node to the right surface",
+                        "Surface ID is:", id_surface, "Surface type is:", this->SurfaceType(id_surface),
+                        "Node number is:", this->mesh_faces(this->listfaces[idir],j));
                 }
             }
 
+            // LARGEST DISTANCE A NODE OF THE FACE IS MOVED TO REACH THE SURFACE
+            this->projection_residuals(idir) = std::max(this->projection_residuals(idir),
+                point_to_be_projected.Distance(xEq)/this->scale);
+            cost.worst_residual = std::max(cost.worst_residual,this->projection_residuals(idir));
+
             if (j<no_face_vertices)
             {
                 // FOR VERTEX NODES KEEP THE DISPLACEMENT ZERO
-                this->displacements_BC(this->index_nodes(j),0) = 0.;
-                this->displacements_BC(this->index_nodes(j),1) = 0.;
-                this->displacements_BC(this->index_nodes(j),2) = 0.;
+                this->displacements_BC(node_offset+j,0) = 0.;
+                this->displacements_BC(node_offset+j,1) = 0.;
+                this->displacements_BC(node_offset+j,2) = 0.;
                 // BUT UPDATE THE MESH POINTS TO CONFORM TO CAD GEOMETRY - NOT TO SCALE
                 this->mesh_points(this->mesh_faces(this->listfaces[idir],j),0) = xEq.X();
                 this->mesh_points(this->mesh_faces(this->listfaces[idir],j),1) = xEq.Y();
@@ -1229,18 +1346,18 @@ void PostMeshSurface::MeshPointInversionSurface(Integer project_on_curves, Integ
             else
             {
                 // FOR NON-VERTEX NODES GET THE REQUIRED DISPLACEMENT
-                this->displacements_BC(this->index_nodes(j),0) = (xEq.X()/this->scale - gp_pnt_old(0));
-                this->displacements_BC(this->index_nodes(j),1) = (xEq.Y()/this->scale - gp_pnt_old(1));
-                this->displacements_BC(this->index_nodes(j),2) = (xEq.Z()/this->scale - gp_pnt_old(2));
+                this->displacements_BC(node_offset+j,0) = (xEq.X()/this->scale - gp_pnt_old(0));
+                this->displacements_BC(node_offset+j,1) = (xEq.Y()/this->scale - gp_pnt_old(1));
+                this->displacements_BC(node_offset+j,2) = (xEq.Z()/this->scale - gp_pnt_old(2));
             }
         }
-        this->index_nodes = ((this->index_nodes).array()+no_face_nodes).eval().matrix();
     }
 }
 
 void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curves,
     Real OrthTol, Real *FEbases, Integer rows, Integer cols)
 {
+    PostMeshPhase phase(this->stats,"MeshPointInversionSurfaceArcLength",&this->diagnostics);
     if (this->mesh_element_type != "tet") {
         warn("Arc-length based projection is only implemented for tetrahedral elements at the moment");
     }
@@ -1248,22 +1365,25 @@ void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curv
     {
         warn("Projection on curves is not implemented in the 3D arc-length based projection. This will be ignored");
     }
-    Eigen::MatrixR FEBases = Eigen::Map<Eigen::MatrixR>(FEbases,rows,cols);
+    const Eigen::Map<const Eigen::MatrixR> FEBases(FEbases,rows,cols);
 
     this->no_dir_faces = this->dirichlet_faces.rows();
     auto no_face_nodes = this->mesh_faces.cols();
-    Eigen::MatrixI arr_row = Eigen::Map<Eigen::Matrix<Integer,Eigen::Dynamic,1> >
-            (this->listfaces.data(),this->listfaces.size());
-    auto arr_col = cnp::arange(no_face_nodes);
-    this->nodes_dir = cnp::take(this->mesh_faces,arr_row,arr_col);
-    this->nodes_dir = cnp::ravel(this->nodes_dir);
-    this->index_nodes = cnp::arange(Integer(no_face_nodes));
+    this->InvalidateDirichletData();
+    this->nodes_dir = cnp::take_rows(this->mesh_faces,this->listfaces,true);
     this->displacements_BC = Eigen::MatrixR::Zero(this->no_dir_faces*no_face_nodes,this->ndim);
+    this->projection_residuals = Eigen::MatrixR::Zero(this->no_dir_faces,1);
+
+    // PARAMETRIC COORDINATES OF THE FACE NODES, REUSED FOR EVERY FACE
+    Eigen::Matrix<Real,3,2,POSTMESH_ALIGNED> face_vertices;
+    Eigen::MatrixR parametric_surface(FEBases.cols(),2);
+    GeomAPI_ProjectPointOnSurf proj;
 
     for (auto idir=0; idir< this->no_dir_faces; ++idir)
     {
         auto id_surface = static_cast<Integer>(this->dirichlet_faces(idir,3));
-        Handle_Geom_Surface current_surface = this->geometry_surfaces[id_surface];
+        const Handle_Geom_Surface &current_surface = this->geometry_surfaces[id_surface];
+        const Integer node_offset = idir*no_face_nodes;
 
         Real u1 = this->projection_U(idir,0);
         Real u2 = this->projection_U(idir,1);
@@ -1273,10 +1393,9 @@ void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curv
         Real v2 = this->projection_V(idir,1);
         Real v3 = this->projection_V(idir,2);
 
-        Eigen::MatrixR face_vertices(3,2);
         face_vertices << u1,v1,u2,v2,u3,v3;
 
-        Eigen::MatrixR parametric_surface = FEBases.transpose()*face_vertices;
+        parametric_surface.noalias() = FEBases.transpose()*face_vertices;
         parametric_surface.block(0,0,3,2) = face_vertices; // NOT NECESSARY
 
         for (auto j=0; j<no_face_nodes;++j)
@@ -1284,9 +1403,9 @@ void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curv
             if (j<static_cast<decltype(j)>(this->ndim))
             {
                 // FOR VERTEX NODES KEEP THE DISPLACEMENT ZERO
-                this->displacements_BC(this->index_nodes(j),0) = 0.;
-                this->displacements_BC(this->index_nodes(j),1) = 0.;
-                this->displacements_BC(this->index_nodes(j),2) = 0.;
+                this->displacements_BC(node_offset+j,0) = 0.;
+                this->displacements_BC(node_offset+j,1) = 0.;
+                this->displacements_BC(node_offset+j,2) = 0.;
             }
             else
             {
@@ -1297,9 +1416,12 @@ void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curv
                 // TRY PROJECTION AS WELL TO RESOLVE FOR INCORRECT NODES
                 auto xEq_Orthogonal = gp_Pnt(gp_pnt_old(0)*this->scale,gp_pnt_old(1)*this->scale,gp_pnt_old(2)*this->scale);
 
+                SurfaceCost &cost = this->stats.Surface(id_surface);
                 try
                 {
-                    GeomAPI_ProjectPointOnSurf proj;
+                    PostMeshTimer timer(cost.inversion_time);
+                    ++this->stats.projections_on_surface;
+                    ++cost.projections;
                     proj.Init(xEq_Orthogonal,current_surface);
                     Real ux, vx;
                     proj.LowerDistanceParameters(ux,vx);
@@ -1307,9 +1429,11 @@ void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curv
                 }
                 catch (StdFail_NotDone)
                 {
-                    warn("Could not project node to the right surface. "
-                         "Surface ID is:", id_surface, "  Surface type is:", this->geometry_surfaces_types[id_surface],
-                         "  Node number is:", this->mesh_faces(this->listfaces[idir],j));
+                    ++this->stats.projection_failures;
+                    ++cost.failures;
+                    this->diagnostics.Report(SEVERITY_WARNING,"Could not project node to the right surface",
+                        "Surface ID is:", id_surface, "Surface type is:", this->SurfaceType(id_surface),
+                        "Node number is:", this->mesh_faces(this->listfaces[idir],j));
                 }
 
                 auto Xdisp_arc = xEq.X()/this->scale - gp_pnt_old(0);
@@ -1333,13 +1457,17 @@ void PostMeshSurface::MeshPointInversionSurfaceArcLength(Integer project_on_curv
                     Zdisp_arc = Zdisp_orth;
                 }
 
+                // LARGEST DISTANCE A NODE OF THE FACE IS MOVED TO REACH THE SURFACE
+                this->projection_residuals(idir) = std::max(this->projection_residuals(idir),
+                    std::sqrt(Xdisp_arc*Xdisp_arc + Ydisp_arc*Ydisp_arc + Zdisp_arc*Zdisp_arc));
+                cost.worst_residual = std::max(cost.worst_residual,this->projection_residuals(idir));
+
                 // FOR NON-VERTEX NODES GET THE REQUIRED DISPLACEMENT
-                this->displacements_BC(this->index_nodes(j),0) = Xdisp_arc;
-                this->displacements_BC(this->index_nodes(j),1) = Ydisp_arc;
-                this->displacements_BC(this->index_nodes(j),2) = Zdisp_arc;
+                this->displacements_BC(node_offset+j,0) = Xdisp_arc;
+                this->displacements_BC(node_offset+j,1) = Ydisp_arc;
+                this->displacements_BC(node_offset+j,2) = Zdisp_arc;
             }
         }
-        this->index_nodes = ((this->index_nodes).array()+no_face_nodes).eval().matrix();
     }
 }
 
@@ -1372,6 +1500,7 @@ std::vector<std::vector<Integer> > PostMeshSurface::GetMeshFacesOnPlanarSurfaces
 
 void PostMeshSurface::GetBoundaryPointsOrder()
 {
+    PostMeshPhase phase(this->stats,"GetBoundaryPointsOrder");
     this->InferInterpolationPolynomialDegree();
     auto C = this->degree - 1;
 
@@ -1428,34 +1557,81 @@ void PostMeshSurface::GetBoundaryPointsOrder()
 
 void PostMeshSurface::GetBoundingBoxOnSurfaces(Real bb_tolerance)
 {
-    std::chrono::high_resolution_clock::time_point t_bb = std::chrono::high_resolution_clock::now();
+    PostMeshPhase phase(this->stats,"GetBoundingBoxOnSurfaces");
+    //! SET UP THE BOUNDING BOXES AROUND THE CAD SURFACES. A BOUNDING BOX IS ONLY
+    //! COMPUTED WHEN A CANDIDATE SEARCH FIRST TESTS A POINT AGAINST IT (SEE
+    //! InBoundingBox), UNLESS THE CAD MODEL IS CACHED, IN WHICH CASE THEY ARE
+    //! ALL TAKEN FROM (OR COMPUTED FOR) THE CACHE
+    const UInteger nsurfaces = this->geometry_surfaces.size();
+    this->bbox_tolerance = bb_tolerance;
+    this->bbox_surfaces = Eigen::MatrixR::Zero(nsurfaces,6);
+    this->bbox_surfaces_materialised.assign(nsurfaces,false);
+
+    // BOUNDING BOXES OF A CACHED CAD MODEL, IF COMPUTED WITH THE SAME TOLERANCE
+    const pio::ArrayRecord *cached_bbox = this->FindCADCache("bbox_surfaces",pio::DTYPE_FLOAT64,nsurfaces,6);
+    const pio::ArrayRecord *cached_tolerance = this->FindCADCache("bbox_tolerance",pio::DTYPE_FLOAT64,1,1);
+    if (cached_bbox != nullptr && cached_tolerance != nullptr &&
+        this->cad_cache->View<Real>(*cached_tolerance)(0,0) == bb_tolerance)
+    {
+        this->bbox_surfaces = this->cad_cache->View<Real>(*cached_bbox);
+        this->bbox_surfaces_materialised.assign(nsurfaces,true);
+        return;
+    }
 
-    this->bbox_surfaces = Eigen::MatrixR::Zero(this->geometry_surfaces.size(),6);
-    for (UInteger isurface=0; isurface<this->geometry_surfaces.size(); ++isurface)
+    if (!this->cad_cache_key.empty())
     {
-        Bnd_Box BB;
-        GeomAdaptor_Surface current_surface = GeomAdaptor_Surface(this->geometry_surfaces[isurface]);
-        // Handle_Geom_BoundedSurface current_bounded_surface = Handle_Geom_BoundedSurface::DownCast(this->geometry_surfaces[isurface]);
-        // GeomAdaptor_Surface current_surface = GeomAdaptor_Surface(current_bounded_surface);
-        // Handle_Geom_BSplineSurface current_bsurface = GeomConvert::SurfaceToBSplineSurface(this->geometry_surfaces[isurface]);
-        // GeomAdaptor_Surface current_surface = GeomAdaptor_Surface(current_bsurface);
-        BndLib_AddSurface::Add(current_surface,
-            current_surface.FirstUParameter(),
-            current_surface.LastUParameter(),
-            current_surface.FirstVParameter(),
-            current_surface.LastVParameter(),
-            bb_tolerance,
-            BB);
-
-        BB.Get( this->bbox_surfaces(isurface,0), this->bbox_surfaces(isurface,1),
-                this->bbox_surfaces(isurface,2), this->bbox_surfaces(isurface,3),
-                this->bbox_surfaces(isurface,4), this->bbox_surfaces(isurface,5));
-        // std::cout << bbox_surfaces.row(isurface) << std::endl;
+        for (UInteger isurface=0; isurface<nsurfaces; ++isurface)
+        {
+            this->MaterialiseBoundingBox(isurface);
+        }
+
+        Eigen::MatrixR tolerance = Eigen::MatrixR::Constant(1,1,bb_tolerance);
+        this->UpdateCADCache({pio::MakeArrayDescriptor("bbox_surfaces",this->bbox_surfaces),
+                              pio::MakeArrayDescriptor("bbox_tolerance",tolerance)});
     }
+}
+
+void PostMeshSurface::MaterialiseBoundingBox(UInteger isurface)
+{
+    //! COMPUTE THE BOUNDING BOX AROUND A CAD SURFACE, IF NOT DONE YET
+    if (this->bbox_surfaces_materialised[isurface])
+        return;
+
+    Bnd_Box BB;
+    GeomAdaptor_Surface current_surface = GeomAdaptor_Surface(this->geometry_surfaces[isurface]);
+    // Handle_Geom_BoundedSurface current_bounded_surface = Handle_Geom_BoundedSurface::DownCast(this->geometry_surfaces[isurface]);
+    // GeomAdaptor_Surface current_surface = GeomAdaptor_Surface(current_bounded_surface);
+    // Handle_Geom_BSplineSurface current_bsurface = GeomConvert::SurfaceToBSplineSurface(this->geometry_surfaces[isurface]);
+    // GeomAdaptor_Surface current_surface = GeomAdaptor_Surface(current_bsurface);
+    BndLib_AddSurface::Add(current_surface,
+        current_surface.FirstUParameter(),
+        current_surface.LastUParameter(),
+        current_surface.FirstVParameter(),
+        current_surface.LastVParameter(),
+        this->bbox_tolerance,
+        BB);
+
+    BB.Get( this->bbox_surfaces(isurface,0), this->bbox_surfaces(isurface,1),
+            this->bbox_surfaces(isurface,2), this->bbox_surfaces(isurface,3),
+            this->bbox_surfaces(isurface,4), this->bbox_surfaces(isurface,5));
+    this->bbox_surfaces_materialised[isurface] = true;
+}
 
-    // t_bb = std::chrono::high_resolution_clock::now() - t_bb;
-    double elapsed_time = std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - t_bb).count();
-    print("Computed bounding box around CAD surfaces in", elapsed_time, "seconds");
+bool PostMeshSurface::InBoundingBox(UInteger isurface, const Eigen::Ref<const Eigen::RowVectorR> &point)
+{
+    //! CHECK IF A POINT LIES INSIDE THE BOUNDING BOX AROUND A CAD SURFACE
+    if (this->bbox_surfaces_materialised.size() != this->geometry_surfaces.size())
+    {
+        this->GetBoundingBoxOnSurfaces(this->bbox_tolerance);
+    }
+    this->MaterialiseBoundingBox(isurface);
+
+    return !(point[0] < this->bbox_surfaces(isurface,0) ||
+             point[1] < this->bbox_surfaces(isurface,1) ||
+             point[2] < this->bbox_surfaces(isurface,2) ||
+             point[0] > this->bbox_surfaces(isurface,3) ||
+             point[1] > this->bbox_surfaces(isurface,4) ||
+             point[2] > this->bbox_surfaces(isurface,5));
 }
 
 std::vector<Integer> PostMeshSurface::GetDirichletFaces()
@@ -1467,3 +1643,39 @@ std::vector<Integer> PostMeshSurface::GetDirichletFaces()
                                this->dirichlet_faces.data()+this->dirichlet_faces.rows()*this->dirichlet_faces.cols());
     return dirichlet_faces_stl;
 }
+
+void PostMeshSurface::WriteVTU(const char *filename)
+{
+    //! WRITE THE CURVED MESH AND ITS PROJECTED BOUNDARY FACES TO A BINARY VTU FILE
+    this->WriteCurvedMeshVTU(filename,this->mesh_faces,this->listfaces,this->dirichlet_faces,"SurfaceID");
+}
+
+void PostMeshSurface::WriteSurfaceProfile(const char *filename, const std::string &sort_by)
+{
+    //! WRITE THE COST PROFILE OF EVERY CAD SURFACE AS CSV, MOST EXPENSIVE
+    //! SURFACE FIRST. SEE PostMeshStats::SurfaceOrder FOR THE SORT KEYS
+    PostMeshStats profile;
+    profile.surfaces = this->stats.surfaces;
+    if (!this->geometry_surfaces.empty())
+        profile.Surface(this->geometry_surfaces.size()-1);
+
+    std::ofstream out(filename);
+    if (!out)
+        throw std::runtime_error(std::string("Unable to write surface profile ")+filename);
+
+    out << "surface,type,total_time,identification_time,projection_time,inversion_time,"
+        << "projections,failures,mean_extrema,worst_residual\n";
+    out.precision(9);
+    for (auto isurface: profile.SurfaceOrder(sort_by))
+    {
+        const SurfaceCost &cost = profile.surfaces[isurface];
+        // SURFACE TYPES ARE GeomAbs_SurfaceType VALUES, -1 FOR A SURFACE THAT
+        // IS NOT PART OF THE CURRENT MODEL
+        const Integer type = isurface < Integer(this->geometry_surfaces.size()) ?
+            Integer(this->SurfaceType(isurface)) : -1;
+        out << isurface << "," << type << "," << cost.TotalTime() << ","
+            << cost.identification_time << "," << cost.projection_time << "," << cost.inversion_time << ","
+            << cost.projections << "," << cost.failures << "," << cost.MeanExtremaSolutions() << ","
+            << cost.worst_residual << "\n";
+    }
+}